@@ -29,11 +29,13 @@
 #include <Kdelibs4Migration>
 #include <KDeclarative/KDeclarative>
 
+#include "bindings/latencymonitor.h"
 #include "bindings/utils.h"
 #include "bindings/stringformatter.h"
 #include "declarativeitems/griditem.h"
 #include "declarativeitems/kcolorschemeproxy.h"
 #include "declarativeitems/lessonpainter.h"
+#include "declarativeitems/lessonscenegraphitem.h"
 #include "declarativeitems/lessontexthighlighteritem.h"
 #include "declarativeitems/preferencesproxy.h"
 #include "declarativeitems/scalebackgrounditem.h"
@@ -45,7 +47,9 @@
 #include "core/course.h"
 #include "core/lesson.h"
 #include "core/profile.h"
+#include "core/sessionjournal.h"
 #include "core/trainingstats.h"
+#include "core/errorheatmap.h"
 #include "core/dataindex.h"
 #include "core/dataaccess.h"
 #include "core/profiledataaccess.h"
@@ -54,6 +58,7 @@
 #include "models/categorizedresourcesortfilterproxymodel.h"
 #include "models/learningprogressmodel.h"
 #include "models/errorsmodel.h"
+#include "models/fingerstatsmodel.h"
 
 
 Application::Application(int& argc, char** argv, int flags):
@@ -100,6 +105,7 @@ void Application::setupDeclarativeBindings(QQmlEngine* qmlEngine)
 
     rootContext->setContextProperty(QStringLiteral("utils"), new Utils());
     rootContext->setContextProperty(QStringLiteral("strFormatter"), new StringFormatter());
+    rootContext->setContextProperty(QStringLiteral("latencyMonitor"), LatencyMonitor::self());
 }
 
 QStringList& Application::qmlImportPaths()
@@ -117,6 +123,8 @@ void Application::registerQmlTypes()
     qmlRegisterType<Course>("ktouch", 1, 0, "Course");
     qmlRegisterType<Lesson>("ktouch", 1, 0, "Lesson");
     qmlRegisterType<TrainingStats>("ktouch", 1, 0, "TrainingStats");
+    qmlRegisterType<SessionJournal>("ktouch", 1, 0, "SessionJournal");
+    qmlRegisterType<ErrorHeatmap>("ktouch", 1, 0, "ErrorHeatmap");
     qmlRegisterType<Profile>("ktouch", 1, 0, "Profile");
     qmlRegisterType<DataIndex>("ktouch", 1, 0, "DataIndex");
     qmlRegisterType<DataIndexCourse>("ktouch", 1, 0, "DataIndexCourse");
@@ -130,13 +138,17 @@ void Application::registerQmlTypes()
     qmlRegisterType<CategorizedResourceSortFilterProxyModel>("ktouch", 1, 0, "CategorizedResourceSortFilterProxyModel");
     qmlRegisterType<LearningProgressModel>("ktouch", 1, 0, "LearningProgressModel");
     qmlRegisterType<ErrorsModel>("ktouch", 1, 0, "ErrorsModel");
+    qmlRegisterType<FingerStatsModel>("ktouch", 1, 0, "FingerStatsModel");
 
     qmlRegisterType<GridItem>("ktouch", 1, 0 , "LineGrid");
     qmlRegisterType<ScaleBackgroundItem>("ktouch", 1, 0, "ScaleBackgroundItem");
     qmlRegisterType<LessonPainter>("ktouch", 1, 0, "LessonPainter");
+    qmlRegisterType<LessonSceneGraphItem>("ktouch", 1, 0, "LessonSceneGraphItem");
     qmlRegisterType<LessonTextHighlighterItem>("ktouch", 1, 0, "LessonTextHighlighter");
     qmlRegisterType<TrainingLineCore>("ktouch", 1, 0, "TrainingLineCore");
     qmlRegisterType<KColorSchemeProxy>("ktouch", 1, 0, "KColorScheme");
+
+    qmlRegisterUncreatableType<LatencyMonitor>("ktouch", 1, 0, "LatencyMonitor", QStringLiteral("use the latencyMonitor context property"));
 }
 
 void Application::migrateKde4Files()
@@ -0,0 +1,124 @@
+/*
+ *  Copyright 2026  The KTouch Developers <kde-edu@kde.org>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest>
+
+#include "core/confusionmatrix.h"
+
+class ConfusionMatrixTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void countsPerCell();
+    void errorCounts();
+    void growth();
+    void errorMapRoundTrip();
+    void codePoints();
+};
+
+void ConfusionMatrixTest::countsPerCell()
+{
+    ConfusionMatrix matrix;
+
+    matrix.add('a', 's');
+    matrix.add('a', 's');
+    matrix.add('a', 'q', 3);
+    matrix.add('e', 'r');
+    matrix.add('e', 'w', 0);
+
+    QCOMPARE(matrix.size(), 3);
+    QCOMPARE(matrix.count('a', 's'), 2);
+    QCOMPARE(matrix.count('a', 'q'), 3);
+    QCOMPARE(matrix.count('e', 'r'), 1);
+    QCOMPARE(matrix.count('e', 'w'), 0);
+    QCOMPARE(matrix.errorCount('a'), 5);
+    QCOMPARE(matrix.errorCount('e'), 1);
+
+    matrix.clear();
+
+    QVERIFY(matrix.isEmpty());
+    QCOMPARE(matrix.count('a', 's'), 0);
+}
+
+void ConfusionMatrixTest::errorCounts()
+{
+    ConfusionMatrix matrix;
+
+    matrix.add('e', 'r', 2);
+    matrix.add('a', 's');
+    matrix.add('e', 'w');
+
+    const QVector<QPair<uint, int> > errorCounts = matrix.errorCounts();
+
+    QCOMPARE(errorCounts.count(), 2);
+    QCOMPARE(errorCounts.at(0), qMakePair(uint('a'), 1));
+    QCOMPARE(errorCounts.at(1), qMakePair(uint('e'), 3));
+}
+
+void ConfusionMatrixTest::growth()
+{
+    ConfusionMatrix matrix;
+
+    // well past the initial capacity, so the table is rehashed a few times
+    for (uint expected = 0x20; expected < 0x20 + 100; expected++)
+    {
+        for (uint typed = 0x20; typed < 0x20 + 10; typed++)
+        {
+            matrix.add(expected, typed, int(typed - 0x1f));
+        }
+    }
+
+    QCOMPARE(matrix.size(), 1000);
+    QCOMPARE(matrix.cells().count(), 1000);
+
+    for (uint expected = 0x20; expected < 0x20 + 100; expected++)
+    {
+        QCOMPARE(matrix.count(expected, 0x25), 6);
+        QCOMPARE(matrix.errorCount(expected), 55);
+    }
+}
+
+void ConfusionMatrixTest::errorMapRoundTrip()
+{
+    const QString grinningFace = QString::fromUcs4(U"\U0001F600");
+    QMap<QString, int> errorMap;
+
+    errorMap.insert(QStringLiteral("a"), 4);
+    errorMap.insert(grinningFace, 2);
+
+    const ConfusionMatrix matrix = ConfusionMatrix::fromErrorMap(errorMap);
+
+    // the typed characters aren't known for error maps
+    QCOMPARE(matrix.count('a', 0), 4);
+    QCOMPARE(matrix.count(0x1F600, 0), 2);
+    QCOMPARE(matrix.toErrorMap(), errorMap);
+}
+
+void ConfusionMatrixTest::codePoints()
+{
+    const QString grinningFace = QString::fromUcs4(U"\U0001F600");
+
+    QCOMPARE(ConfusionMatrix::codePoint(QString()), uint(0));
+    QCOMPARE(ConfusionMatrix::codePoint(QStringLiteral("e\u0301")), uint('e'));
+    QCOMPARE(ConfusionMatrix::codePoint(grinningFace), uint(0x1F600));
+    QCOMPARE(ConfusionMatrix::character(0x1F600), grinningFace);
+    QCOMPARE(ConfusionMatrix::character(0), QString());
+}
+
+QTEST_GUILESS_MAIN(ConfusionMatrixTest)
+
+#include "confusionmatrixtest.moc"
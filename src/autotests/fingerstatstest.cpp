@@ -0,0 +1,172 @@
+/*
+ *  Copyright 2026  The KTouch Developers <kde-edu@kde.org>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest>
+
+#include "core/fingerstats.h"
+#include "core/key.h"
+#include "core/keychar.h"
+#include "core/keyboardlayout.h"
+#include "core/specialkey.h"
+
+class FingerStatsTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void init();
+    void cleanup();
+    void fingerLookup();
+    void noKeyboardLayout();
+    void keystrokesAndErrors();
+    void meanInterval();
+    void unknownCharacterIsIgnored();
+    void clear();
+private:
+    void addKey(int fingerIndex, const QString& chars);
+    KeyboardLayout* m_keyboardLayout;
+};
+
+void FingerStatsTest::init()
+{
+    m_keyboardLayout = new KeyboardLayout();
+    addKey(3, QStringLiteral("fF"));
+    addKey(4, QStringLiteral("j"));
+    // the first key wins for a character found on several keys
+    addKey(5, QStringLiteral("J"));
+    addKey(6, QStringLiteral("j"));
+    // out of range fingers are skipped
+    addKey(FingerStats::FingerCount, QStringLiteral("x"));
+    m_keyboardLayout->addKey(new SpecialKey());
+}
+
+void FingerStatsTest::cleanup()
+{
+    delete m_keyboardLayout;
+    m_keyboardLayout = 0;
+}
+
+void FingerStatsTest::addKey(int fingerIndex, const QString& chars)
+{
+    Key* key = new Key();
+    key->setFingerIndex(fingerIndex);
+
+    foreach (const QChar& c, chars)
+    {
+        KeyChar* keyChar = new KeyChar();
+        keyChar->setValue(c);
+        key->addKeyChar(keyChar);
+    }
+
+    m_keyboardLayout->addKey(key);
+}
+
+void FingerStatsTest::fingerLookup()
+{
+    FingerStats stats;
+    stats.setKeyboardLayout(m_keyboardLayout);
+
+    QCOMPARE(stats.finger('f'), 3);
+    QCOMPARE(stats.finger('F'), 3);
+    QCOMPARE(stats.finger('j'), 4);
+    QCOMPARE(stats.finger('J'), 5);
+    QCOMPARE(stats.finger('x'), -1);
+    QCOMPARE(stats.finger('a'), -1);
+    QCOMPARE(stats.finger(0x1F600), -1);
+}
+
+void FingerStatsTest::noKeyboardLayout()
+{
+    FingerStats stats;
+    QCOMPARE(stats.finger('f'), -1);
+
+    stats.setKeyboardLayout(m_keyboardLayout);
+    stats.setKeyboardLayout(0);
+    QCOMPARE(stats.finger('f'), -1);
+}
+
+void FingerStatsTest::keystrokesAndErrors()
+{
+    FingerStats stats;
+    stats.setKeyboardLayout(m_keyboardLayout);
+
+    stats.add('f', true, -1);
+    stats.add('F', false, -1);
+    stats.add('f', true, -1);
+    stats.add('j', true, -1);
+
+    QCOMPARE(stats.at(3).keystrokes, quint32(3));
+    QCOMPARE(stats.at(3).errors, quint32(1));
+    QCOMPARE(stats.at(3).errorRate(), 1.0 / 3);
+    QCOMPARE(stats.at(4).keystrokes, quint32(1));
+    QCOMPARE(stats.at(4).errorRate(), 0.0);
+    QCOMPARE(stats.at(0).keystrokes, quint32(0));
+    QCOMPARE(stats.at(0).errorRate(), 0.0);
+}
+
+void FingerStatsTest::meanInterval()
+{
+    FingerStats stats;
+    stats.setKeyboardLayout(m_keyboardLayout);
+
+    stats.add('f', true, 100000000);
+    stats.add('f', true, 200000000);
+    QCOMPARE(stats.at(3).intervalCount, quint32(2));
+    QCOMPARE(stats.at(3).meanInterval, 150.0);
+
+    // errors and keystrokes without an interval don't affect the mean
+    stats.add('f', false, 1000000);
+    stats.add('f', true, -1);
+    QCOMPARE(stats.at(3).keystrokes, quint32(4));
+    QCOMPARE(stats.at(3).intervalCount, quint32(2));
+    QCOMPARE(stats.at(3).meanInterval, 150.0);
+}
+
+void FingerStatsTest::unknownCharacterIsIgnored()
+{
+    FingerStats stats;
+    stats.setKeyboardLayout(m_keyboardLayout);
+
+    stats.add('x', false, 1000000);
+    stats.add(0x1F600, true, 1000000);
+
+    for (int index = 0; index < FingerStats::FingerCount; index++)
+    {
+        QCOMPARE(stats.at(index).keystrokes, quint32(0));
+    }
+}
+
+void FingerStatsTest::clear()
+{
+    FingerStats stats;
+    stats.setKeyboardLayout(m_keyboardLayout);
+
+    stats.add('f', false, -1);
+    stats.add('j', true, 100000000);
+    stats.clear();
+
+    QCOMPARE(stats.at(3).keystrokes, quint32(0));
+    QCOMPARE(stats.at(3).errors, quint32(0));
+    QCOMPARE(stats.at(4).intervalCount, quint32(0));
+    QCOMPARE(stats.at(4).meanInterval, 0.0);
+
+    // the lookup survives
+    QCOMPARE(stats.finger('f'), 3);
+}
+
+QTEST_GUILESS_MAIN(FingerStatsTest)
+
+#include "fingerstatstest.moc"
@@ -0,0 +1,132 @@
+/*
+ *  Copyright 2026  The KTouch Developers <kde-edu@kde.org>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest>
+
+#include "declarativeitems/lineheights.h"
+
+class LineHeightsTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void empty();
+    void topAndTotal();
+    void setHeight();
+    void lineAt();
+    void matchesLinearSums();
+};
+
+void LineHeightsTest::empty()
+{
+    LineHeights heights;
+
+    QCOMPARE(heights.count(), 0);
+    QCOMPARE(heights.total(), qreal(0));
+    QCOMPARE(heights.lineAt(0), 0);
+    QCOMPARE(heights.lineAt(100), 0);
+}
+
+void LineHeightsTest::topAndTotal()
+{
+    LineHeights heights;
+    heights.reset(QVector<qreal>() << 10 << 20 << 30 << 40 << 50);
+
+    QCOMPARE(heights.count(), 5);
+    QCOMPARE(heights.height(2), qreal(30));
+    QCOMPARE(heights.top(0), qreal(0));
+    QCOMPARE(heights.top(1), qreal(10));
+    QCOMPARE(heights.top(3), qreal(60));
+    QCOMPARE(heights.top(4), qreal(100));
+    QCOMPARE(heights.total(), qreal(150));
+
+    // past the last line is the total
+    QCOMPARE(heights.top(9), qreal(150));
+}
+
+void LineHeightsTest::setHeight()
+{
+    LineHeights heights;
+    heights.reset(QVector<qreal>() << 10 << 20 << 30 << 40 << 50);
+
+    heights.setHeight(1, 25);
+    QCOMPARE(heights.height(1), qreal(25));
+    QCOMPARE(heights.top(1), qreal(10));
+    QCOMPARE(heights.top(2), qreal(35));
+    QCOMPARE(heights.top(4), qreal(105));
+    QCOMPARE(heights.total(), qreal(155));
+
+    heights.setHeight(4, 0);
+    QCOMPARE(heights.top(4), qreal(105));
+    QCOMPARE(heights.total(), qreal(105));
+}
+
+void LineHeightsTest::lineAt()
+{
+    LineHeights heights;
+    heights.reset(QVector<qreal>() << 10 << 20 << 30 << 40 << 50);
+
+    QCOMPARE(heights.lineAt(-5), 0);
+    QCOMPARE(heights.lineAt(0), 0);
+    QCOMPARE(heights.lineAt(9.5), 0);
+    QCOMPARE(heights.lineAt(10), 1);
+    QCOMPARE(heights.lineAt(29), 1);
+    QCOMPARE(heights.lineAt(30), 2);
+    QCOMPARE(heights.lineAt(99), 3);
+    QCOMPARE(heights.lineAt(100), 4);
+    QCOMPARE(heights.lineAt(149), 4);
+
+    // below the last line still maps to it
+    QCOMPARE(heights.lineAt(150), 4);
+    QCOMPARE(heights.lineAt(1000), 4);
+}
+
+void LineHeightsTest::matchesLinearSums()
+{
+    // a count that isn't a power of two exercises every level of the tree
+    const int count = 37;
+    QVector<qreal> values;
+
+    for (int line = 0; line < count; line++)
+    {
+        values << (line * 7) % 11 + 1;
+    }
+
+    LineHeights heights;
+    heights.reset(values);
+
+    for (int line = 0; line < count; line += 3)
+    {
+        values[line] = line % 5 + 2;
+        heights.setHeight(line, values.at(line));
+    }
+
+    qreal top = 0;
+
+    for (int line = 0; line < count; line++)
+    {
+        QCOMPARE(heights.top(line), top);
+        QCOMPARE(heights.lineAt(top), line);
+        QCOMPARE(heights.lineAt(top + values.at(line) / 2), line);
+        top += values.at(line);
+    }
+
+    QCOMPARE(heights.total(), top);
+}
+
+QTEST_GUILESS_MAIN(LineHeightsTest)
+
+#include "lineheightstest.moc"
@@ -0,0 +1,138 @@
+/*
+ *  Copyright 2026  The KTouch Developers <kde-edu@kde.org>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest>
+
+#include "core/ngramstats.h"
+
+class NGramStatsTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void meanAndVariance();
+    void ngramText();
+    void probing();
+    void dropWhenFull();
+    void clear();
+};
+
+void NGramStatsTest::meanAndVariance()
+{
+    NGramStats stats(2, 16);
+    const uint ab[] = {'a', 'b'};
+    const uint ba[] = {'b', 'a'};
+
+    stats.add(ab, 100);
+    stats.add(ab, 200);
+    stats.add(ab, 300);
+    stats.add(ba, 50);
+
+    const NGramStats::Entry* entry = stats.find(ab);
+    QVERIFY(entry);
+    QCOMPARE(entry->count, quint32(3));
+    QCOMPARE(entry->mean, 200.0);
+    QCOMPARE(entry->variance(), 10000.0);
+
+    // a single sample has no variance
+    entry = stats.find(ba);
+    QVERIFY(entry);
+    QCOMPARE(entry->count, quint32(1));
+    QCOMPARE(entry->mean, 50.0);
+    QCOMPARE(entry->variance(), 0.0);
+
+    QCOMPARE(stats.size(), 2);
+}
+
+void NGramStatsTest::ngramText()
+{
+    NGramStats stats(3, 16);
+    const uint codePoints[] = {'x', 0x1F600, 0xE9};
+
+    stats.add(codePoints, 10);
+
+    const QVector<NGramStats::Entry> entries = stats.entries();
+    QCOMPARE(entries.count(), 1);
+    QCOMPARE(stats.ngram(entries.first()), QString::fromUcs4(codePoints, 3));
+}
+
+void NGramStatsTest::probing()
+{
+    NGramStats stats(1, 64);
+
+    // forty keys in 64 slots are bound to collide and be probed past
+    for (uint c = 'a'; c < 'a' + 40; c++)
+    {
+        stats.add(&c, c);
+        stats.add(&c, c + 2);
+    }
+
+    QCOMPARE(stats.size(), 40);
+    QCOMPARE(stats.droppedCount(), 0);
+
+    for (uint c = 'a'; c < 'a' + 40; c++)
+    {
+        const NGramStats::Entry* entry = stats.find(&c);
+        QVERIFY(entry);
+        QCOMPARE(entry->count, quint32(2));
+        QCOMPARE(entry->mean, double(c + 1));
+    }
+
+    const uint missing = 'A';
+    QVERIFY(!stats.find(&missing));
+}
+
+void NGramStatsTest::dropWhenFull()
+{
+    // a table of 8 slots takes 6 keys
+    NGramStats stats(1, 8);
+
+    for (uint c = 'a'; c < 'a' + 6; c++)
+    {
+        stats.add(&c, 1);
+    }
+
+    const uint extra = 'z';
+    stats.add(&extra, 1);
+
+    QCOMPARE(stats.size(), 6);
+    QCOMPARE(stats.droppedCount(), 1);
+    QVERIFY(!stats.find(&extra));
+
+    // known keys are still counted
+    const uint known = 'a';
+    stats.add(&known, 3);
+    QCOMPARE(stats.find(&known)->count, quint32(2));
+    QCOMPARE(stats.droppedCount(), 1);
+}
+
+void NGramStatsTest::clear()
+{
+    NGramStats stats(1, 8);
+    const uint c = 'a';
+
+    stats.add(&c, 1);
+    stats.clear();
+
+    QCOMPARE(stats.size(), 0);
+    QCOMPARE(stats.droppedCount(), 0);
+    QVERIFY(!stats.find(&c));
+    QVERIFY(stats.entries().isEmpty());
+}
+
+QTEST_GUILESS_MAIN(NGramStatsTest)
+
+#include "ngramstatstest.moc"
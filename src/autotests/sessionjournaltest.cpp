@@ -0,0 +1,198 @@
+/*
+ *  Copyright 2026  The KTouch Developers <kde-edu@kde.org>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest>
+
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QStandardPaths>
+#include <QUuid>
+
+#include "core/sessionjournal.h"
+
+// the record layout written by SessionJournal
+enum {
+    CheckpointRecord = 1,
+    EndRecord
+};
+
+static QDataStream& operator<<(QDataStream& stream, const ConfusionMatrix::Cell& cell)
+{
+    return stream << quint32(cell.expected) << quint32(cell.typed) << qint32(cell.count);
+}
+
+class SessionJournalTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void init();
+    void cleanup();
+    void noJournal();
+    void latestCheckpointWins();
+    void endedSessionsAreSkipped();
+    void emptySessionsAreSkipped();
+    void tornTail_data();
+    void tornTail();
+private:
+    static QByteArray record(const QByteArray& payload);
+    static QByteArray checkpoint(const QByteArray& sessionId, int charactersTyped, int errorCount);
+    static QByteArray end(const QByteArray& sessionId);
+    static void writeJournal(const QByteArray& data);
+    QByteArray m_sessionId;
+};
+
+void SessionJournalTest::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+    QVERIFY(QDir().mkpath(QFileInfo(SessionJournal::journalPath()).absolutePath()));
+}
+
+void SessionJournalTest::init()
+{
+    SessionJournal::clear();
+    m_sessionId = QUuid::createUuid().toRfc4122();
+}
+
+void SessionJournalTest::cleanup()
+{
+    SessionJournal::clear();
+}
+
+QByteArray SessionJournalTest::record(const QByteArray& payload)
+{
+    QByteArray result;
+    QDataStream stream(&result, QIODevice::WriteOnly);
+    stream << quint32(payload.size()) << qChecksum(payload.constData(), uint(payload.size()));
+    result.append(payload);
+    return result;
+}
+
+QByteArray SessionJournalTest::checkpoint(const QByteArray& sessionId, int charactersTyped, int errorCount)
+{
+    const ConfusionMatrix::Cell cell = {'a', 's', errorCount};
+    QVector<ConfusionMatrix::Cell> confusions;
+
+    if (errorCount > 0)
+    {
+        confusions.append(cell);
+    }
+
+    QByteArray payload;
+    QDataStream stream(&payload, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_9);
+    stream << quint8(CheckpointRecord) << sessionId << qint32(7) << QStringLiteral("course")
+           << QStringLiteral("lesson") << qint64(1000) << qint32(charactersTyped) << qint32(errorCount)
+           << quint64(charactersTyped * 100) << confusions;
+    return record(payload);
+}
+
+QByteArray SessionJournalTest::end(const QByteArray& sessionId)
+{
+    QByteArray payload;
+    QDataStream stream(&payload, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_9);
+    stream << quint8(EndRecord) << sessionId;
+    return record(payload);
+}
+
+void SessionJournalTest::writeJournal(const QByteArray& data)
+{
+    QFile file(SessionJournal::journalPath());
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    QCOMPARE(file.write(data), qint64(data.size()));
+}
+
+void SessionJournalTest::noJournal()
+{
+    QVERIFY(SessionJournal::pendingSessions().isEmpty());
+}
+
+void SessionJournalTest::latestCheckpointWins()
+{
+    writeJournal(checkpoint(m_sessionId, 10, 1) + checkpoint(m_sessionId, 20, 2));
+
+    const QList<SessionCheckpoint> sessions = SessionJournal::pendingSessions();
+    QCOMPARE(sessions.count(), 1);
+
+    const SessionCheckpoint& session = sessions.first();
+    QCOMPARE(session.sessionId, QUuid::fromRfc4122(m_sessionId).toString());
+    QCOMPARE(session.profileId, 7);
+    QCOMPARE(session.courseId, QStringLiteral("course"));
+    QCOMPARE(session.lessonId, QStringLiteral("lesson"));
+    QCOMPARE(session.date, qint64(1000));
+    QCOMPARE(session.charactersTyped, 20);
+    QCOMPARE(session.errorCount, 2);
+    QCOMPARE(session.elapsedTime, quint64(2000));
+    QCOMPARE(session.confusions.count(), 1);
+    QCOMPARE(session.confusions.first().expected, uint('a'));
+    QCOMPARE(session.confusions.first().typed, uint('s'));
+    QCOMPARE(session.confusions.first().count, 2);
+}
+
+void SessionJournalTest::endedSessionsAreSkipped()
+{
+    const QByteArray otherSessionId = QUuid::createUuid().toRfc4122();
+
+    writeJournal(checkpoint(otherSessionId, 5, 0) + checkpoint(m_sessionId, 10, 0) + end(otherSessionId));
+
+    const QList<SessionCheckpoint> sessions = SessionJournal::pendingSessions();
+    QCOMPARE(sessions.count(), 1);
+    QCOMPARE(sessions.first().sessionId, QUuid::fromRfc4122(m_sessionId).toString());
+}
+
+void SessionJournalTest::emptySessionsAreSkipped()
+{
+    writeJournal(checkpoint(m_sessionId, 0, 0));
+
+    QVERIFY(SessionJournal::pendingSessions().isEmpty());
+}
+
+void SessionJournalTest::tornTail_data()
+{
+    QTest::addColumn<QByteArray>("tail");
+
+    const QByteArray next = checkpoint(QUuid::createUuid().toRfc4122(), 30, 3);
+    QByteArray corrupted = next;
+    corrupted[corrupted.size() - 1] = corrupted.at(corrupted.size() - 1) ^ 0x1;
+
+    QTest::newRow("partial header") << next.left(3);
+    QTest::newRow("partial payload") << next.left(next.size() - 5);
+    QTest::newRow("bad checksum") << corrupted;
+    QTest::newRow("oversized record") << QByteArray("\x7f\xff\xff\xff\x00\x00garbage", 13);
+    // a checksum matching a payload too short to parse
+    QTest::newRow("truncated checkpoint") << record(QByteArray("\x01", 1));
+}
+
+void SessionJournalTest::tornTail()
+{
+    QFETCH(QByteArray, tail);
+
+    writeJournal(checkpoint(m_sessionId, 10, 1) + tail);
+
+    const QList<SessionCheckpoint> sessions = SessionJournal::pendingSessions();
+    QCOMPARE(sessions.count(), 1);
+    QCOMPARE(sessions.first().sessionId, QUuid::fromRfc4122(m_sessionId).toString());
+    QCOMPARE(sessions.first().charactersTyped, 10);
+    QCOMPARE(sessions.first().errorCount, 1);
+}
+
+QTEST_GUILESS_MAIN(SessionJournalTest)
+
+#include "sessionjournaltest.moc"
@@ -0,0 +1,142 @@
+/*
+ *  Copyright 2026  The KTouch Developers <kde-edu@kde.org>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest>
+
+#include "replay/sessionlog.h"
+
+class SessionLogTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void varintEncoding_data();
+    void varintEncoding();
+    void varintRoundTrip();
+    void truncatedVarint();
+    void stringRoundTrip();
+    void truncatedString();
+};
+
+void SessionLogTest::varintEncoding_data()
+{
+    QTest::addColumn<quint64>("value");
+    QTest::addColumn<QByteArray>("encoded");
+
+    QTest::newRow("zero") << quint64(0) << QByteArray("\x00", 1);
+    QTest::newRow("one byte") << quint64(127) << QByteArray("\x7f");
+    QTest::newRow("two bytes") << quint64(128) << QByteArray("\x80\x01");
+    QTest::newRow("300") << quint64(300) << QByteArray("\xac\x02");
+    QTest::newRow("max") << Q_UINT64_C(0xffffffffffffffff) << QByteArray("\xff\xff\xff\xff\xff\xff\xff\xff\xff\x01");
+}
+
+void SessionLogTest::varintEncoding()
+{
+    QFETCH(quint64, value);
+    QFETCH(QByteArray, encoded);
+
+    QByteArray buffer;
+    SessionLog::writeVarint(buffer, value);
+    QCOMPARE(buffer, encoded);
+
+    int position = 0;
+    quint64 decoded;
+    QVERIFY(SessionLog::readVarint(buffer, position, decoded));
+    QCOMPARE(decoded, value);
+    QCOMPARE(position, buffer.size());
+}
+
+void SessionLogTest::varintRoundTrip()
+{
+    const QList<quint64> values = QList<quint64>() << 0 << 1 << 0x7f << 0x80 << 0x3fff << 0x4000
+        << Q_UINT64_C(0xffffffff) << Q_UINT64_C(0x100000000) << Q_UINT64_C(0x7fffffffffffffff);
+
+    QByteArray buffer;
+
+    foreach (quint64 value, values)
+    {
+        SessionLog::writeVarint(buffer, value);
+    }
+
+    int position = 0;
+
+    foreach (quint64 value, values)
+    {
+        quint64 decoded;
+        QVERIFY(SessionLog::readVarint(buffer, position, decoded));
+        QCOMPARE(decoded, value);
+    }
+
+    QCOMPARE(position, buffer.size());
+}
+
+void SessionLogTest::truncatedVarint()
+{
+    quint64 value;
+    int position = 0;
+
+    QVERIFY(!SessionLog::readVarint(QByteArray(), position, value));
+
+    QByteArray buffer;
+    SessionLog::writeVarint(buffer, 300);
+    buffer.chop(1);
+    position = 0;
+    QVERIFY(!SessionLog::readVarint(buffer, position, value));
+}
+
+void SessionLogTest::stringRoundTrip()
+{
+    const QStringList strings = QStringList() << QString() << QStringLiteral("ktouch")
+        << QStringLiteral("\u00e9t\u00e9") << QString::fromUcs4(U"\U0001F600") << QString(200, QLatin1Char('x'));
+
+    QByteArray buffer;
+
+    foreach (const QString& string, strings)
+    {
+        SessionLog::writeString(buffer, string);
+    }
+
+    int position = 0;
+
+    foreach (const QString& string, strings)
+    {
+        QString decoded;
+        QVERIFY(SessionLog::readString(buffer, position, decoded));
+        QCOMPARE(decoded, string);
+    }
+
+    QCOMPARE(position, buffer.size());
+}
+
+void SessionLogTest::truncatedString()
+{
+    QByteArray buffer;
+    SessionLog::writeString(buffer, QStringLiteral("ktouch"));
+    buffer.chop(1);
+
+    QString string;
+    int position = 0;
+    QVERIFY(!SessionLog::readString(buffer, position, string));
+
+    // a size without its varint end byte
+    buffer = QByteArray("\x80");
+    position = 0;
+    QVERIFY(!SessionLog::readString(buffer, position, string));
+}
+
+QTEST_GUILESS_MAIN(SessionLogTest)
+
+#include "sessionlogtest.moc"
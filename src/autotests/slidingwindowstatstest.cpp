@@ -0,0 +1,134 @@
+/*
+ *  Copyright 2026  The KTouch Developers <kde-edu@kde.org>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest>
+
+#include "core/slidingwindowstats.h"
+
+class SlidingWindowStatsTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void accuracyWindow();
+    void errorsDontCountForSpeed();
+    void speedWindowWraps();
+    void speedWindowGrows();
+    void clear();
+};
+
+void SlidingWindowStatsTest::accuracyWindow()
+{
+    SlidingWindowStats stats(1000, 4);
+
+    QCOMPARE(stats.accuracy(), 1.0f);
+
+    stats.add(0, true);
+    stats.add(1, false);
+    stats.add(2, true);
+    stats.add(3, true);
+
+    QCOMPARE(stats.recentKeystrokes(), 4);
+    QCOMPARE(stats.recentErrors(), 1);
+    QCOMPARE(stats.accuracy(), 0.75f);
+
+    // the oldest keystrokes drop out of the full window
+    stats.add(4, true);
+    QCOMPARE(stats.recentKeystrokes(), 4);
+    QCOMPARE(stats.recentErrors(), 1);
+
+    stats.add(5, true);
+    QCOMPARE(stats.recentErrors(), 0);
+    QCOMPARE(stats.accuracy(), 1.0f);
+}
+
+void SlidingWindowStatsTest::errorsDontCountForSpeed()
+{
+    SlidingWindowStats stats(1000, 10);
+
+    stats.add(0, true);
+    stats.add(10, false);
+    stats.add(20, true);
+
+    QCOMPARE(stats.recentCharacters(), 2);
+    QCOMPARE(stats.recentKeystrokes(), 3);
+}
+
+void SlidingWindowStatsTest::speedWindowWraps()
+{
+    SlidingWindowStats stats(1000, 10);
+
+    // goes round the ring of 256 timestamps several times
+    for (qint64 timestamp = 0; timestamp < 30000; timestamp += 100)
+    {
+        stats.add(timestamp, true);
+        QVERIFY(stats.recentCharacters() <= 11);
+    }
+
+    QCOMPARE(stats.recentCharacters(), 11);
+
+    stats.expire(30400);
+    QCOMPARE(stats.recentCharacters(), 6);
+
+    stats.expire(31000);
+    QCOMPARE(stats.recentCharacters(), 0);
+}
+
+void SlidingWindowStatsTest::speedWindowGrows()
+{
+    SlidingWindowStats stats(1000, 10);
+
+    // move the head of the ring away from the start first
+    for (qint64 timestamp = 0; timestamp < 2000; timestamp += 10)
+    {
+        stats.add(timestamp, true);
+    }
+
+    QCOMPARE(stats.recentCharacters(), 101);
+
+    // a burst of more than 256 characters within the window
+    for (qint64 timestamp = 2000; timestamp < 2400; timestamp++)
+    {
+        stats.add(timestamp, true);
+    }
+
+    QCOMPARE(stats.recentCharacters(), 460);
+
+    // the timestamps are still in order after the ring has grown
+    stats.expire(3000);
+    QCOMPARE(stats.recentCharacters(), 400);
+
+    stats.expire(3300);
+    QCOMPARE(stats.recentCharacters(), 100);
+}
+
+void SlidingWindowStatsTest::clear()
+{
+    SlidingWindowStats stats(1000, 10);
+
+    stats.add(0, true);
+    stats.add(1, false);
+    stats.clear();
+
+    QCOMPARE(stats.recentCharacters(), 0);
+    QCOMPARE(stats.recentKeystrokes(), 0);
+    QCOMPARE(stats.recentErrors(), 0);
+    QCOMPARE(stats.accuracy(), 1.0f);
+}
+
+QTEST_GUILESS_MAIN(SlidingWindowStatsTest)
+
+#include "slidingwindowstatstest.moc"
@@ -0,0 +1,154 @@
+/*
+ *  Copyright 2026  The KTouch Developers <kde-edu@kde.org>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest>
+
+#include <QInputMethodEvent>
+#include <QKeyEvent>
+#include <QStandardPaths>
+
+#include "declarativeitems/traininglinecore.h"
+#include "preferences.h"
+
+class TrainingLineCoreTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void init();
+    void cleanup();
+    void clusterStartsAndEnds();
+    void backspaceRemovesCorrectCluster();
+    void backspaceInCombiningSequence();
+    void backspaceAfterWrongSurrogatePair();
+    void wrongCodePointInCombiningSequence();
+private:
+    void type(const QString& text);
+    void backspace();
+    TrainingLineCore* m_core;
+};
+
+void TrainingLineCoreTest::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+    Preferences::setEnforceTypingErrorCorrection(true);
+}
+
+void TrainingLineCoreTest::init()
+{
+    m_core = new TrainingLineCore();
+    m_core->setActive(true);
+}
+
+void TrainingLineCoreTest::cleanup()
+{
+    delete m_core;
+    m_core = 0;
+}
+
+void TrainingLineCoreTest::type(const QString& text)
+{
+    QInputMethodEvent event;
+    event.setCommitString(text);
+    QCoreApplication::sendEvent(m_core, &event);
+}
+
+void TrainingLineCoreTest::backspace()
+{
+    QKeyEvent event(QEvent::KeyPress, Qt::Key_Backspace, Qt::NoModifier);
+    QCoreApplication::sendEvent(m_core, &event);
+}
+
+void TrainingLineCoreTest::clusterStartsAndEnds()
+{
+    const QString line = QStringLiteral("ae\u0301") + QString::fromUcs4(U"\U0001F600") + QStringLiteral("b");
+
+    m_core->setReferenceLine(line);
+
+    QCOMPARE(m_core->graphemeClusterStart(2), 1);
+    QCOMPARE(m_core->graphemeClusterEnd(1), 3);
+    QCOMPARE(m_core->graphemeClusterStart(4), 3);
+    QCOMPARE(m_core->graphemeClusterEnd(3), 5);
+    QCOMPARE(m_core->graphemeClusterEnd(5), 6);
+}
+
+void TrainingLineCoreTest::backspaceRemovesCorrectCluster()
+{
+    m_core->setReferenceLine(QStringLiteral("ae\u0301"));
+
+    type(QStringLiteral("ae\u0301"));
+    QVERIFY(m_core->isCorrect());
+
+    backspace();
+    QCOMPARE(m_core->actualLine(), QStringLiteral("a"));
+    QVERIFY(m_core->isCorrect());
+}
+
+void TrainingLineCoreTest::backspaceInCombiningSequence()
+{
+    m_core->setReferenceLine(QStringLiteral("e\u0301"));
+
+    type(QStringLiteral("e"));
+    QVERIFY(m_core->isCorrect());
+
+    type(QStringLiteral("x"));
+    QVERIFY(!m_core->isCorrect());
+
+    backspace();
+    QCOMPARE(m_core->actualLine(), QStringLiteral("e"));
+    QVERIFY(m_core->isCorrect());
+
+    type(QStringLiteral("\u0301"));
+    QCOMPARE(m_core->actualLine(), QStringLiteral("e\u0301"));
+    QVERIFY(m_core->isCorrect());
+}
+
+void TrainingLineCoreTest::backspaceAfterWrongSurrogatePair()
+{
+    const QString grinningFace = QString::fromUcs4(U"\U0001F600");
+    const QString smilingFace = QString::fromUcs4(U"\U0001F603");
+
+    m_core->setReferenceLine(QStringLiteral("a") + grinningFace);
+
+    type(QStringLiteral("a"));
+    type(smilingFace);
+    QVERIFY(!m_core->isCorrect());
+
+    // both halves of the pair go at once
+    backspace();
+    QCOMPARE(m_core->actualLine(), QStringLiteral("a"));
+    QVERIFY(m_core->isCorrect());
+
+    type(grinningFace);
+    QVERIFY(m_core->isCorrect());
+}
+
+void TrainingLineCoreTest::wrongCodePointInCombiningSequence()
+{
+    m_core->setReferenceLine(QStringLiteral("e\u0301"));
+
+    type(QStringLiteral("e\u0300"));
+    QVERIFY(!m_core->isCorrect());
+
+    backspace();
+    QCOMPARE(m_core->actualLine(), QStringLiteral("e"));
+    QVERIFY(m_core->isCorrect());
+}
+
+QTEST_MAIN(TrainingLineCoreTest)
+
+#include "traininglinecoretest.moc"
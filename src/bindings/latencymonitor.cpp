@@ -0,0 +1,354 @@
+/*
+ *  Copyright 2026  The KTouch Developers <kde-edu@kde.org>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "latencymonitor.h"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutexLocker>
+#include <QQuickWindow>
+#include <QStringList>
+#include <QtDebug>
+
+#include <algorithm>
+
+#include <qmath.h>
+
+static const qint64 BucketWidthNSecs = 100000;
+
+LatencyHistogram::LatencyHistogram()
+{
+    clear();
+}
+
+void LatencyHistogram::add(qint64 nsecs)
+{
+    const qint64 bucket = qMax(Q_INT64_C(0), nsecs) / BucketWidthNSecs;
+    m_buckets[qMin(bucket, qint64(BucketCount))]++;
+    m_count++;
+    m_maximum = qMax(m_maximum, nsecs);
+}
+
+void LatencyHistogram::clear()
+{
+    std::fill(m_buckets, m_buckets + BucketCount + 1, 0);
+    m_count = 0;
+    m_maximum = 0;
+}
+
+int LatencyHistogram::count() const
+{
+    return m_count;
+}
+
+qreal LatencyHistogram::percentile(qreal fraction) const
+{
+    if (m_count == 0)
+        return 0;
+
+    const int rank = qMax(1, qCeil(fraction * m_count));
+    int seen = 0;
+
+    for (int i = 0; i < BucketCount; i++)
+    {
+        seen += m_buckets[i];
+
+        if (seen >= rank)
+        {
+            return (i + 1) * bucketWidth();
+        }
+    }
+
+    return maximum();
+}
+
+qreal LatencyHistogram::maximum() const
+{
+    return m_maximum / 1000000.0;
+}
+
+QVector<int> LatencyHistogram::buckets() const
+{
+    return QVector<int>(m_buckets, m_buckets + BucketCount + 1);
+}
+
+qreal LatencyHistogram::bucketWidth()
+{
+    return BucketWidthNSecs / 1000000.0;
+}
+
+LatencyMonitor::LatencyMonitor(QObject* parent) :
+    QObject(parent),
+    m_enabled(0),
+    m_inputTimestamp(-1),
+    m_lineChangedTimestamp(-1),
+    m_paintTimestamp(-1)
+{
+    m_clock.start();
+}
+
+LatencyMonitor* LatencyMonitor::self()
+{
+    static LatencyMonitor* instance = 0;
+
+    if (!instance)
+    {
+        instance = new LatencyMonitor(QCoreApplication::instance());
+    }
+
+    return instance;
+}
+
+bool LatencyMonitor::isEnabled() const
+{
+    return m_enabled.load() != 0;
+}
+
+void LatencyMonitor::setEnabled(bool enabled)
+{
+    if (enabled != isEnabled())
+    {
+        m_enabled.store(enabled? 1: 0);
+        resetSession();
+        emit enabledChanged();
+    }
+}
+
+QString LatencyMonitor::logFile() const
+{
+    return m_logFile;
+}
+
+void LatencyMonitor::setLogFile(const QString& logFile)
+{
+    if (logFile != m_logFile)
+    {
+        m_logFile = logFile;
+        emit logFileChanged();
+    }
+}
+
+int LatencyMonitor::sampleCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_histograms[FrameSwappedStage].count();
+}
+
+QString LatencyMonitor::summary() const
+{
+    static const char* const labels[StageCount] = {"line", "paint", "photon"};
+
+    QMutexLocker locker(&m_mutex);
+    QStringList lines;
+
+    for (int stage = 0; stage < StageCount; stage++)
+    {
+        const LatencyHistogram& histogram = m_histograms[stage];
+        lines << QStringLiteral("%1: p50 %2 ms, p95 %3 ms, p99 %4 ms")
+            .arg(QLatin1String(labels[stage]))
+            .arg(histogram.percentile(0.5), 0, 'f', 1)
+            .arg(histogram.percentile(0.95), 0, 'f', 1)
+            .arg(histogram.percentile(0.99), 0, 'f', 1);
+    }
+
+    lines << QStringLiteral("%1 samples").arg(m_histograms[FrameSwappedStage].count());
+
+    return lines.join(QLatin1Char('\n'));
+}
+
+void LatencyMonitor::attachWindow(QQuickWindow* window)
+{
+    if (!window)
+        return;
+
+    // ### frameSwapped() is emitted on the render thread, take the timestamp right there
+    connect(window, &QQuickWindow::frameSwapped, this, &LatencyMonitor::markFrameSwapped, Qt::ConnectionType(Qt::DirectConnection | Qt::UniqueConnection));
+}
+
+qreal LatencyMonitor::percentile(Stage stage, qreal fraction) const
+{
+    if (stage < 0 || stage >= StageCount)
+        return 0;
+
+    QMutexLocker locker(&m_mutex);
+    return m_histograms[stage].percentile(fraction);
+}
+
+void LatencyMonitor::resetSession()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+
+        for (int stage = 0; stage < StageCount; stage++)
+        {
+            m_histograms[stage].clear();
+        }
+
+        m_inputTimestamp = -1;
+        m_lineChangedTimestamp = -1;
+        m_paintTimestamp = -1;
+    }
+
+    emit histogramsChanged();
+}
+
+void LatencyMonitor::finishSession(const QString& lessonId)
+{
+    if (!isEnabled())
+        return;
+
+    if (!m_logFile.isEmpty() && sampleCount() > 0)
+    {
+        exportToFile(m_logFile, lessonId);
+    }
+
+    resetSession();
+}
+
+bool LatencyMonitor::exportToFile(const QString& path, const QString& lessonId) const
+{
+    static const char* const keys[StageCount] = {"lineChanged", "paint", "frameSwapped"};
+
+    QJsonObject stages;
+
+    {
+        QMutexLocker locker(&m_mutex);
+
+        for (int stage = 0; stage < StageCount; stage++)
+        {
+            const LatencyHistogram& histogram = m_histograms[stage];
+            QJsonArray buckets;
+
+            foreach (int count, histogram.buckets())
+            {
+                buckets.append(count);
+            }
+
+            QJsonObject stageObject;
+            stageObject.insert(QStringLiteral("count"), histogram.count());
+            stageObject.insert(QStringLiteral("p50"), histogram.percentile(0.5));
+            stageObject.insert(QStringLiteral("p95"), histogram.percentile(0.95));
+            stageObject.insert(QStringLiteral("p99"), histogram.percentile(0.99));
+            stageObject.insert(QStringLiteral("max"), histogram.maximum());
+            stageObject.insert(QStringLiteral("buckets"), buckets);
+            stages.insert(QLatin1String(keys[stage]), stageObject);
+        }
+    }
+
+    QJsonObject session;
+    session.insert(QStringLiteral("date"), QDateTime::currentDateTime().toString(Qt::ISODate));
+    session.insert(QStringLiteral("lessonId"), lessonId);
+    session.insert(QStringLiteral("bucketWidth"), LatencyHistogram::bucketWidth());
+    session.insert(QStringLiteral("stages"), stages);
+
+    QFile file(path);
+
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text))
+    {
+        qWarning() << "can't open" << path << "for writing:" << file.errorString();
+        return false;
+    }
+
+    file.write(QJsonDocument(session).toJson(QJsonDocument::Compact));
+    file.write("\n");
+
+    return true;
+}
+
+void LatencyMonitor::markInput()
+{
+    if (!isEnabled())
+        return;
+
+    QMutexLocker locker(&m_mutex);
+
+    // measure from the oldest input not yet on screen
+    if (m_inputTimestamp == -1)
+    {
+        m_inputTimestamp = m_clock.nsecsElapsed();
+        m_lineChangedTimestamp = -1;
+        m_paintTimestamp = -1;
+    }
+}
+
+void LatencyMonitor::discardInput()
+{
+    if (!isEnabled())
+        return;
+
+    QMutexLocker locker(&m_mutex);
+
+    if (m_lineChangedTimestamp == -1)
+    {
+        m_inputTimestamp = -1;
+    }
+}
+
+void LatencyMonitor::markLineChanged()
+{
+    if (!isEnabled())
+        return;
+
+    QMutexLocker locker(&m_mutex);
+
+    if (m_inputTimestamp != -1 && m_lineChangedTimestamp == -1)
+    {
+        m_lineChangedTimestamp = m_clock.nsecsElapsed();
+    }
+}
+
+void LatencyMonitor::markPaint()
+{
+    if (!isEnabled())
+        return;
+
+    QMutexLocker locker(&m_mutex);
+
+    if (m_lineChangedTimestamp != -1 && m_paintTimestamp == -1)
+    {
+        m_paintTimestamp = m_clock.nsecsElapsed();
+    }
+}
+
+void LatencyMonitor::markFrameSwapped()
+{
+    if (!isEnabled())
+        return;
+
+    {
+        QMutexLocker locker(&m_mutex);
+
+        if (m_paintTimestamp == -1)
+            return;
+
+        const qint64 now = m_clock.nsecsElapsed();
+
+        m_histograms[LineChangedStage].add(m_lineChangedTimestamp - m_inputTimestamp);
+        m_histograms[PaintStage].add(m_paintTimestamp - m_inputTimestamp);
+        m_histograms[FrameSwappedStage].add(now - m_inputTimestamp);
+
+        m_inputTimestamp = -1;
+        m_lineChangedTimestamp = -1;
+        m_paintTimestamp = -1;
+    }
+
+    QMetaObject::invokeMethod(this, "histogramsChanged", Qt::QueuedConnection);
+}
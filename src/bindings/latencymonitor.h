@@ -0,0 +1,102 @@
+/*
+ *  Copyright 2026  The KTouch Developers <kde-edu@kde.org>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LATENCYMONITOR_H
+#define LATENCYMONITOR_H
+
+#include <QObject>
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+class QQuickWindow;
+
+class LatencyHistogram
+{
+public:
+    LatencyHistogram();
+    void add(qint64 nsecs);
+    void clear();
+    int count() const;
+    qreal percentile(qreal fraction) const;
+    qreal maximum() const;
+    QVector<int> buckets() const;
+    static qreal bucketWidth();
+private:
+    enum { BucketCount = 1000 };
+    int m_buckets[BucketCount + 1];
+    int m_count;
+    qint64 m_maximum;
+};
+
+class LatencyMonitor : public QObject
+{
+    Q_OBJECT
+    Q_ENUMS(Stage)
+    Q_PROPERTY(bool enabled READ isEnabled WRITE setEnabled NOTIFY enabledChanged)
+    Q_PROPERTY(QString logFile READ logFile WRITE setLogFile NOTIFY logFileChanged)
+    Q_PROPERTY(int sampleCount READ sampleCount NOTIFY histogramsChanged)
+    Q_PROPERTY(QString summary READ summary NOTIFY histogramsChanged)
+
+public:
+    enum Stage {
+        LineChangedStage,
+        PaintStage,
+        FrameSwappedStage,
+        StageCount
+    };
+
+    static LatencyMonitor* self();
+    bool isEnabled() const;
+    void setEnabled(bool enabled);
+    QString logFile() const;
+    void setLogFile(const QString& logFile);
+    int sampleCount() const;
+    QString summary() const;
+    void attachWindow(QQuickWindow* window);
+    Q_INVOKABLE qreal percentile(Stage stage, qreal fraction) const;
+    Q_INVOKABLE void resetSession();
+    Q_INVOKABLE void finishSession(const QString& lessonId = QString());
+    Q_INVOKABLE bool exportToFile(const QString& path, const QString& lessonId = QString()) const;
+
+public slots:
+    void markInput();
+    void discardInput();
+    void markLineChanged();
+    void markPaint();
+    void markFrameSwapped();
+
+signals:
+    void enabledChanged();
+    void logFileChanged();
+    void histogramsChanged();
+
+private:
+    explicit LatencyMonitor(QObject* parent = 0);
+    QAtomicInt m_enabled;
+    QString m_logFile;
+    QElapsedTimer m_clock;
+    mutable QMutex m_mutex;
+    qint64 m_inputTimestamp;
+    qint64 m_lineChangedTimestamp;
+    qint64 m_paintTimestamp;
+    LatencyHistogram m_histograms[StageCount];
+};
+
+#endif // LATENCYMONITOR_H
@@ -0,0 +1,209 @@
+/*
+ *  Copyright 2026  The KTouch Developers <kde-edu@kde.org>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "confusionmatrix.h"
+
+#include <algorithm>
+
+static const int InitialCapacity = 128;
+
+static inline uint hashCell(uint expected, uint typed)
+{
+    return (expected * 0x9E3779B1u) ^ (typed * 0x85EBCA77u);
+}
+
+ConfusionMatrix::ConfusionMatrix() :
+    m_size(0)
+{
+    rehash(InitialCapacity);
+}
+
+void ConfusionMatrix::add(uint expected, uint typed, int count)
+{
+    if (count <= 0)
+        return;
+
+    // grow before the table gets more than 3/4 full
+    if ((m_size + 1) * 4 > m_cells.size() * 3)
+    {
+        rehash(m_cells.size() * 2);
+    }
+
+    Cell& cell = m_cells[find(expected, typed)];
+
+    if (cell.count == 0)
+    {
+        cell.expected = expected;
+        cell.typed = typed;
+        m_size++;
+    }
+
+    cell.count += count;
+}
+
+void ConfusionMatrix::clear()
+{
+    const Cell empty = {0, 0, 0};
+    m_cells.fill(empty);
+    m_size = 0;
+}
+
+bool ConfusionMatrix::isEmpty() const
+{
+    return m_size == 0;
+}
+
+int ConfusionMatrix::size() const
+{
+    return m_size;
+}
+
+int ConfusionMatrix::count(uint expected, uint typed) const
+{
+    return m_cells.at(find(expected, typed)).count;
+}
+
+int ConfusionMatrix::errorCount(uint expected) const
+{
+    int result = 0;
+
+    for (const Cell& cell: m_cells)
+    {
+        if (cell.count > 0 && cell.expected == expected)
+        {
+            result += cell.count;
+        }
+    }
+
+    return result;
+}
+
+QVector<ConfusionMatrix::Cell> ConfusionMatrix::cells() const
+{
+    QVector<Cell> result;
+    result.reserve(m_size);
+
+    for (const Cell& cell: m_cells)
+    {
+        if (cell.count > 0)
+        {
+            result.append(cell);
+        }
+    }
+
+    return result;
+}
+
+QVector<QPair<uint, int> > ConfusionMatrix::errorCounts() const
+{
+    QVector<Cell> sortedCells = cells();
+
+    std::sort(sortedCells.begin(), sortedCells.end(), [](const Cell& left, const Cell& right) {
+        return left.expected < right.expected;
+    });
+
+    QVector<QPair<uint, int> > result;
+
+    for (const Cell& cell: sortedCells)
+    {
+        if (!result.isEmpty() && result.last().first == cell.expected)
+        {
+            result.last().second += cell.count;
+        }
+        else
+        {
+            result.append(qMakePair(cell.expected, cell.count));
+        }
+    }
+
+    return result;
+}
+
+QMap<QString, int> ConfusionMatrix::toErrorMap() const
+{
+    QMap<QString, int> result;
+
+    for (const auto& errorCount: errorCounts())
+    {
+        result.insert(character(errorCount.first), errorCount.second);
+    }
+
+    return result;
+}
+
+ConfusionMatrix ConfusionMatrix::fromErrorMap(const QMap<QString, int>& errorMap)
+{
+    ConfusionMatrix result;
+
+    for (auto it = errorMap.constBegin(); it != errorMap.constEnd(); ++it)
+    {
+        result.add(codePoint(it.key()), 0, it.value());
+    }
+
+    return result;
+}
+
+uint ConfusionMatrix::codePoint(const QString& character)
+{
+    if (character.isEmpty())
+        return 0;
+
+    if (character.length() > 1 && character.at(0).isHighSurrogate() && character.at(1).isLowSurrogate())
+        return QChar::surrogateToUcs4(character.at(0), character.at(1));
+
+    return character.at(0).unicode();
+}
+
+QString ConfusionMatrix::character(uint codePoint)
+{
+    return codePoint != 0? QString::fromUcs4(&codePoint, 1): QString();
+}
+
+int ConfusionMatrix::find(uint expected, uint typed) const
+{
+    const int mask = m_cells.size() - 1;
+    int index = int(hashCell(expected, typed) & uint(mask));
+
+    while (true)
+    {
+        const Cell& cell = m_cells.at(index);
+
+        if (cell.count == 0 || (cell.expected == expected && cell.typed == typed))
+            return index;
+
+        index = (index + 1) & mask;
+    }
+}
+
+void ConfusionMatrix::rehash(int capacity)
+{
+    const QVector<Cell> oldCells = m_cells;
+    const Cell empty = {0, 0, 0};
+
+    m_cells = QVector<Cell>(capacity, empty);
+    m_size = 0;
+
+    for (const Cell& cell: oldCells)
+    {
+        if (cell.count > 0)
+        {
+            Cell& newCell = m_cells[find(cell.expected, cell.typed)];
+            newCell = cell;
+            m_size++;
+        }
+    }
+}
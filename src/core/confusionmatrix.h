@@ -0,0 +1,61 @@
+/*
+ *  Copyright 2026  The KTouch Developers <kde-edu@kde.org>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CONFUSIONMATRIX_H
+#define CONFUSIONMATRIX_H
+
+#include <QtGlobal>
+#include <QMap>
+#include <QPair>
+#include <QString>
+#include <QVector>
+
+class ConfusionMatrix
+{
+public:
+    struct Cell
+    {
+        uint expected;
+        // 0 if the typed character is unknown, e.g. for data from old sessions
+        uint typed;
+        int count;
+    };
+
+    ConfusionMatrix();
+    void add(uint expected, uint typed, int count = 1);
+    void clear();
+    bool isEmpty() const;
+    int size() const;
+    int count(uint expected, uint typed) const;
+    int errorCount(uint expected) const;
+    QVector<Cell> cells() const;
+    QVector<QPair<uint, int> > errorCounts() const;
+    QMap<QString, int> toErrorMap() const;
+    static ConfusionMatrix fromErrorMap(const QMap<QString, int>& errorMap);
+    static uint codePoint(const QString& character);
+    static QString character(uint codePoint);
+
+private:
+    int find(uint expected, uint typed) const;
+    void rehash(int capacity);
+    QVector<Cell> m_cells;
+    int m_size;
+};
+
+Q_DECLARE_TYPEINFO(ConfusionMatrix::Cell, Q_PRIMITIVE_TYPE);
+
+#endif // CONFUSIONMATRIX_H
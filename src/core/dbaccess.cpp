@@ -106,12 +106,24 @@ bool DbAccess::checkDbSchema()
 
         versionQuery.clear();
 
+        // migrated databases go on to get the tables added since
         if (version == QLatin1String("1.0"))
         {
-            return migrateFrom1_0To1_1();
+            if (!migrateFrom1_0To1_1())
+                return false;
+
+            version = QStringLiteral("1.1");
+        }
+
+        if (version == QLatin1String("1.1"))
+        {
+            if (!migrateFrom1_1To1_2())
+                return false;
+
+            version = QStringLiteral("1.2");
         }
 
-        if (version != QLatin1String("1.1"))
+        if (version != QLatin1String("1.2"))
         {
             m_errorMessage = i18n("Invalid database version '%1'.", version);
             emit errorMessageChanged();
@@ -126,7 +138,7 @@ bool DbAccess::checkDbSchema()
             raiseError(db.lastError());
             return false;
         }
-        db.exec(QStringLiteral("INSERT INTO metadata (key, value) VALUES ('version', '1.1')"));
+        db.exec(QStringLiteral("INSERT INTO metadata (key, value) VALUES ('version', '1.2')"));
         if (db.lastError().isValid())
         {
             qWarning() << db.lastError().text();
@@ -163,7 +175,8 @@ bool DbAccess::checkDbSchema()
             "date INT, "
             "characters_typed INTEGER, "
             "error_count INTEGER, "
-            "elapsed_time INTEGER "
+            "elapsed_time INTEGER, "
+            "session_id TEXT "
             ")");
 
     if (db.lastError().isValid())
@@ -187,6 +200,53 @@ bool DbAccess::checkDbSchema()
         return false;
     }
 
+    db.exec("CREATE TABLE IF NOT EXISTS training_stats_confusions ("
+            "id INTEGER PRIMARY KEY AUTOINCREMENT, "
+            "stats_id INTEGER, "
+            "expected_character TEXT, "
+            "typed_character TEXT, "
+            "count INTEGER "
+            ")");
+
+    if (db.lastError().isValid())
+    {
+        qWarning() << db.lastError().text();
+        raiseError(db.lastError());
+        return false;
+    }
+
+    db.exec("CREATE TABLE IF NOT EXISTS training_stats_ngrams ("
+            "id INTEGER PRIMARY KEY AUTOINCREMENT, "
+            "stats_id INTEGER, "
+            "ngram TEXT, "
+            "count INTEGER, "
+            "mean_interval REAL, "
+            "interval_variance REAL "
+            ")");
+
+    if (db.lastError().isValid())
+    {
+        qWarning() << db.lastError().text();
+        raiseError(db.lastError());
+        return false;
+    }
+
+    db.exec("CREATE TABLE IF NOT EXISTS training_stats_fingers ("
+            "id INTEGER PRIMARY KEY AUTOINCREMENT, "
+            "stats_id INTEGER, "
+            "finger INTEGER, "
+            "keystrokes INTEGER, "
+            "error_count INTEGER, "
+            "mean_interval REAL "
+            ")");
+
+    if (db.lastError().isValid())
+    {
+        qWarning() << db.lastError().text();
+        raiseError(db.lastError());
+        return false;
+    }
+
     db.exec("CREATE TABLE IF NOT EXISTS course_progress ("
             "id INTEGER PRIMARY KEY AUTOINCREMENT, "
             "profile_id INTEGER, "
@@ -420,3 +480,48 @@ bool DbAccess::migrateFrom1_0To1_1()
 
     return true;
 }
+
+bool DbAccess::migrateFrom1_1To1_2()
+{
+    QSqlDatabase db = QSqlDatabase::database();
+
+    if (!db.transaction())
+    {
+        qWarning() <<  db.lastError().text();
+        raiseError(db.lastError());
+        db.rollback();
+        return false;
+    }
+
+    // the session a row was saved for, crash recovery must not save it twice
+    db.exec("ALTER TABLE training_stats "
+            "ADD COLUMN session_id TEXT");
+
+    if (db.lastError().isValid())
+    {
+        qWarning() << db.lastError().text();
+        raiseError(db.lastError());
+        db.rollback();
+        return false;
+    }
+
+    db.exec(QStringLiteral("UPDATE metadata SET value = '1.2' WHERE key = 'version'"));
+
+    if (db.lastError().isValid())
+    {
+        qWarning() << db.lastError().text();
+        raiseError(db.lastError());
+        db.rollback();
+        return false;
+    }
+
+    if (!db.commit())
+    {
+        qWarning() << db.lastError().text();
+        raiseError(db.lastError());
+        db.rollback();
+        return false;
+    }
+
+    return true;
+}
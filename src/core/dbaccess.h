@@ -40,6 +40,7 @@ protected:
 private:
     bool checkDbSchema();
     bool migrateFrom1_0To1_1();
+    bool migrateFrom1_1To1_2();
     QString m_errorMessage;
 };
 
@@ -0,0 +1,323 @@
+/*
+ *  Copyright 2026  The KTouch Developers <kde-edu@kde.org>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "errorheatmap.h"
+
+#include <QSqlQuery>
+
+#include "core/confusionmatrix.h"
+#include "core/keyboardlayout.h"
+#include "core/profile.h"
+#include "core/profiledataaccess.h"
+#include "core/trainingstats.h"
+
+ErrorHeatmap::ErrorHeatmap(QObject* parent) :
+    QAbstractListModel(parent),
+    m_maximumErrors(0),
+    m_loggedKeystrokes(0),
+    m_committedKeystrokes(0)
+{
+}
+
+Profile* ErrorHeatmap::profile() const
+{
+    return m_profile;
+}
+
+void ErrorHeatmap::setProfile(Profile* profile)
+{
+    if (profile != m_profile)
+    {
+        m_profile = profile;
+        update();
+        emit profileChanged();
+    }
+}
+
+KeyboardLayout* ErrorHeatmap::keyboardLayout() const
+{
+    return m_keyboardLayout;
+}
+
+void ErrorHeatmap::setKeyboardLayout(KeyboardLayout* keyboardLayout)
+{
+    if (keyboardLayout != m_keyboardLayout)
+    {
+        if (m_keyboardLayout)
+        {
+            m_keyboardLayout->disconnect(this);
+        }
+
+        m_keyboardLayout = keyboardLayout;
+
+        if (m_keyboardLayout)
+        {
+            connect(m_keyboardLayout.data(), &KeyboardLayout::isValidChanged, this, &ErrorHeatmap::update);
+        }
+
+        update();
+        emit keyboardLayoutChanged();
+    }
+}
+
+TrainingStats* ErrorHeatmap::trainingStats() const
+{
+    return m_trainingStats;
+}
+
+void ErrorHeatmap::setTrainingStats(TrainingStats* trainingStats)
+{
+    if (trainingStats != m_trainingStats)
+    {
+        if (m_trainingStats)
+        {
+            m_trainingStats->disconnect(this);
+        }
+
+        m_trainingStats = trainingStats;
+        m_loggedKeystrokes = m_trainingStats? m_trainingStats->keystrokeCount(): 0;
+        m_committedKeystrokes = m_loggedKeystrokes;
+
+        if (m_trainingStats)
+        {
+            connect(m_trainingStats.data(), &TrainingStats::keystrokesChanged, this, &ErrorHeatmap::onKeystrokes);
+            connect(m_trainingStats.data(), &TrainingStats::sessionReset, this, &ErrorHeatmap::onSessionReset);
+        }
+
+        emit trainingStatsChanged();
+    }
+}
+
+const QVector<float>& ErrorHeatmap::intensities() const
+{
+    return m_intensities;
+}
+
+qreal ErrorHeatmap::intensity(int keyIndex) const
+{
+    return keyIndex >= 0 && keyIndex < m_intensities.size()? m_intensities.at(keyIndex): 0.0;
+}
+
+QVariant ErrorHeatmap::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || role != IntensityRole)
+        return QVariant();
+
+    return intensity(index.row());
+}
+
+int ErrorHeatmap::rowCount(const QModelIndex& parent) const
+{
+    if (parent.isValid())
+        return 0;
+
+    return m_intensities.size();
+}
+
+QHash<int, QByteArray> ErrorHeatmap::roleNames() const
+{
+    QHash<int, QByteArray> names = QAbstractListModel::roleNames();
+    names.insert(ErrorHeatmap::IntensityRole, "intensity");
+    return names;
+}
+
+void ErrorHeatmap::update()
+{
+    beginResetModel();
+
+    m_storedErrors.clear();
+    m_sessionErrors.clear();
+    m_maximumErrors = 0;
+
+    if (m_keyboardLayout && m_keyboardLayout->isValid())
+    {
+        m_storedErrors.fill(0, m_keyboardLayout->keyCount());
+        m_sessionErrors.fill(0, m_keyboardLayout->keyCount());
+
+        if (m_profile)
+        {
+            ProfileDataAccess access;
+            QSqlQuery query = access.errorCountsQuery(m_profile);
+
+            while (query.next())
+            {
+                const int index = keyIndex(query.value(0).toString());
+
+                if (index != -1)
+                {
+                    m_storedErrors[index] += query.value(1).toInt();
+                    m_maximumErrors = qMax(m_maximumErrors, m_storedErrors.at(index));
+                }
+            }
+        }
+    }
+
+    // the errors of the running session are in the database only once it has been saved
+    if (m_trainingStats)
+    {
+        m_loggedKeystrokes = m_committedKeystrokes;
+        logKeystrokes();
+    }
+
+    computeIntensities();
+
+    endResetModel();
+}
+
+void ErrorHeatmap::commit()
+{
+    if (m_trainingStats)
+    {
+        onKeystrokes();
+    }
+
+    // the session has been saved, its errors belong to the stored ones now
+    for (int index = 0; index < m_sessionErrors.size(); index++)
+    {
+        m_storedErrors[index] += m_sessionErrors.at(index);
+        m_sessionErrors[index] = 0;
+    }
+
+    m_committedKeystrokes = m_loggedKeystrokes;
+}
+
+void ErrorHeatmap::onKeystrokes()
+{
+    const int maximumErrors = m_maximumErrors;
+    const QVector<int> changedKeys = logKeystrokes();
+
+    if (changedKeys.isEmpty())
+        return;
+
+    // only a new maximum changes the intensity of the other keys
+    if (m_maximumErrors != maximumErrors)
+    {
+        updateIntensities();
+        return;
+    }
+
+    foreach (int index, changedKeys)
+    {
+        updateIntensity(index);
+    }
+}
+
+void ErrorHeatmap::onSessionReset()
+{
+    m_loggedKeystrokes = 0;
+    m_committedKeystrokes = 0;
+
+    bool changed = false;
+
+    // an abandoned session leaves no trace, a saved one has been committed before
+    for (int index = 0; index < m_sessionErrors.size(); index++)
+    {
+        changed = changed || m_sessionErrors.at(index) != 0;
+        m_sessionErrors[index] = 0;
+    }
+
+    if (!changed)
+        return;
+
+    m_maximumErrors = 0;
+
+    for (int index = 0; index < m_storedErrors.size(); index++)
+    {
+        m_maximumErrors = qMax(m_maximumErrors, m_storedErrors.at(index));
+    }
+
+    updateIntensities();
+}
+
+QVector<int> ErrorHeatmap::logKeystrokes()
+{
+    const int keystrokeCount = m_trainingStats->keystrokeCount();
+    QVector<int> changedKeys;
+
+    if (m_sessionErrors.isEmpty())
+    {
+        m_loggedKeystrokes = keystrokeCount;
+        return changedKeys;
+    }
+
+    for (; m_loggedKeystrokes < keystrokeCount; m_loggedKeystrokes++)
+    {
+        const Keystroke& keystroke = m_trainingStats->keystrokeTimeline().at(m_loggedKeystrokes);
+
+        if (keystroke.correct)
+            continue;
+
+        const int index = keyIndex(ConfusionMatrix::character(keystroke.expected));
+
+        if (index == -1)
+            continue;
+
+        m_sessionErrors[index]++;
+        m_maximumErrors = qMax(m_maximumErrors, keyErrors(index));
+        changedKeys.append(index);
+    }
+
+    return changedKeys;
+}
+
+int ErrorHeatmap::keyIndex(const QString& character) const
+{
+    const QList<int> keyIndexes = m_keyboardLayout->findKeys(character);
+
+    if (keyIndexes.isEmpty() || keyIndexes.first() >= m_storedErrors.size())
+        return -1;
+
+    return keyIndexes.first();
+}
+
+int ErrorHeatmap::keyErrors(int keyIndex) const
+{
+    return m_storedErrors.at(keyIndex) + m_sessionErrors.at(keyIndex);
+}
+
+void ErrorHeatmap::updateIntensity(int keyIndex)
+{
+    const float intensity = m_maximumErrors > 0? float(keyErrors(keyIndex)) / m_maximumErrors: 0.0f;
+
+    if (intensity == m_intensities.at(keyIndex))
+        return;
+
+    m_intensities[keyIndex] = intensity;
+
+    const QModelIndex modelIndex = index(keyIndex);
+    emit dataChanged(modelIndex, modelIndex, QVector<int>() << IntensityRole);
+}
+
+void ErrorHeatmap::computeIntensities()
+{
+    m_intensities.resize(m_storedErrors.size());
+
+    for (int index = 0; index < m_storedErrors.size(); index++)
+    {
+        m_intensities[index] = m_maximumErrors > 0? float(keyErrors(index)) / m_maximumErrors: 0.0f;
+    }
+}
+
+void ErrorHeatmap::updateIntensities()
+{
+    computeIntensities();
+
+    if (!m_intensities.isEmpty())
+    {
+        emit dataChanged(index(0), index(m_intensities.size() - 1), QVector<int>() << IntensityRole);
+    }
+}
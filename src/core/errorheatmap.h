@@ -0,0 +1,86 @@
+/*
+ *  Copyright 2026  The KTouch Developers <kde-edu@kde.org>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ERRORHEATMAP_H
+#define ERRORHEATMAP_H
+
+#include <QAbstractListModel>
+#include <QPointer>
+#include <QVector>
+
+class KeyboardLayout;
+class Profile;
+class TrainingStats;
+
+class ErrorHeatmap : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(Profile* profile READ profile WRITE setProfile NOTIFY profileChanged)
+    Q_PROPERTY(KeyboardLayout* keyboardLayout READ keyboardLayout WRITE setKeyboardLayout NOTIFY keyboardLayoutChanged)
+    Q_PROPERTY(TrainingStats* trainingStats READ trainingStats WRITE setTrainingStats NOTIFY trainingStatsChanged)
+
+public:
+    enum AdditionalRoles {
+        IntensityRole = Qt::UserRole + 1
+    };
+    Q_ENUM(AdditionalRoles)
+
+    explicit ErrorHeatmap(QObject* parent = 0);
+    Profile* profile() const;
+    void setProfile(Profile* profile);
+    KeyboardLayout* keyboardLayout() const;
+    void setKeyboardLayout(KeyboardLayout* keyboardLayout);
+    TrainingStats* trainingStats() const;
+    void setTrainingStats(TrainingStats* trainingStats);
+    const QVector<float>& intensities() const;
+    Q_INVOKABLE qreal intensity(int keyIndex) const;
+    QVariant data(const QModelIndex& index, int role) const override;
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+public slots:
+    void update();
+    void commit();
+
+signals:
+    void profileChanged();
+    void keyboardLayoutChanged();
+    void trainingStatsChanged();
+
+private slots:
+    void onKeystrokes();
+    void onSessionReset();
+
+private:
+    QVector<int> logKeystrokes();
+    int keyIndex(const QString& character) const;
+    int keyErrors(int keyIndex) const;
+    void computeIntensities();
+    void updateIntensity(int keyIndex);
+    void updateIntensities();
+    QPointer<Profile> m_profile;
+    QPointer<KeyboardLayout> m_keyboardLayout;
+    QPointer<TrainingStats> m_trainingStats;
+    QVector<int> m_storedErrors;
+    QVector<int> m_sessionErrors;
+    QVector<float> m_intensities;
+    int m_maximumErrors;
+    int m_loggedKeystrokes;
+    int m_committedKeystrokes;
+};
+
+#endif // ERRORHEATMAP_H
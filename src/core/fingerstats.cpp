@@ -0,0 +1,108 @@
+/*
+ *  Copyright 2026  The KTouch Developers <kde-edu@kde.org>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "fingerstats.h"
+
+#include <algorithm>
+
+#include "core/key.h"
+#include "core/keychar.h"
+#include "core/keyboardlayout.h"
+
+double FingerStats::Finger::errorRate() const
+{
+    return keystrokes > 0? double(errors) / keystrokes: 0.0;
+}
+
+FingerStats::FingerStats()
+{
+    clear();
+}
+
+void FingerStats::setKeyboardLayout(const KeyboardLayout* keyboardLayout)
+{
+    m_fingerLookup.clear();
+
+    if (!keyboardLayout)
+        return;
+
+    // a flat table indexed by code point, so logging a keystroke costs a
+    // single array access
+    for (int index = 0; index < keyboardLayout->keyCount(); index++)
+    {
+        Key* const key = qobject_cast<Key*>(keyboardLayout->key(index));
+
+        if (!key || key->fingerIndex() < 0 || key->fingerIndex() >= FingerCount)
+            continue;
+
+        foreach (KeyChar* keyChar, key->keyChars())
+        {
+            const int codePoint = keyChar->value().unicode();
+
+            if (codePoint >= m_fingerLookup.size())
+            {
+                const int size = m_fingerLookup.size();
+                m_fingerLookup.resize(codePoint + 1);
+                std::fill(m_fingerLookup.begin() + size, m_fingerLookup.end(), qint8(-1));
+            }
+
+            if (m_fingerLookup.at(codePoint) == -1)
+            {
+                m_fingerLookup[codePoint] = qint8(key->fingerIndex());
+            }
+        }
+    }
+}
+
+void FingerStats::add(uint expected, bool correct, qint64 interval)
+{
+    const int index = finger(expected);
+
+    if (index == -1)
+        return;
+
+    Finger& stats = m_fingers[index];
+
+    stats.keystrokes++;
+
+    if (!correct)
+    {
+        stats.errors++;
+        return;
+    }
+
+    if (interval >= 0)
+    {
+        stats.intervalCount++;
+        stats.meanInterval += (interval / 1000000.0 - stats.meanInterval) / stats.intervalCount;
+    }
+}
+
+void FingerStats::clear()
+{
+    for (int index = 0; index < FingerCount; index++)
+    {
+        const Finger empty = {0, 0, 0, 0.0};
+        m_fingers[index] = empty;
+    }
+}
+
+const FingerStats::Finger& FingerStats::at(int finger) const
+{
+    Q_ASSERT(finger >= 0 && finger < FingerCount);
+    return m_fingers[finger];
+}
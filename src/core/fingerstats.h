@@ -0,0 +1,61 @@
+/*
+ *  Copyright 2026  The KTouch Developers <kde-edu@kde.org>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef FINGERSTATS_H
+#define FINGERSTATS_H
+
+#include <QtGlobal>
+#include <QVector>
+
+class KeyboardLayout;
+
+class FingerStats
+{
+public:
+    enum {
+        FingerCount = 8
+    };
+
+    struct Finger
+    {
+        quint32 keystrokes;
+        quint32 errors;
+        quint32 intervalCount;
+        double meanInterval;
+        double errorRate() const;
+    };
+
+    FingerStats();
+    void setKeyboardLayout(const KeyboardLayout* keyboardLayout);
+    int finger(uint codePoint) const;
+    void add(uint expected, bool correct, qint64 interval);
+    void clear();
+    const Finger& at(int finger) const;
+
+private:
+    QVector<qint8> m_fingerLookup;
+    Finger m_fingers[FingerCount];
+};
+
+Q_DECLARE_TYPEINFO(FingerStats::Finger, Q_PRIMITIVE_TYPE);
+
+inline int FingerStats::finger(uint codePoint) const
+{
+    return codePoint < uint(m_fingerLookup.size())? m_fingerLookup.at(int(codePoint)): -1;
+}
+
+#endif // FINGERSTATS_H
@@ -17,6 +17,8 @@
 
 #include "keyboardlayout.h"
 
+#include <algorithm>
+
 #include <QFile>
 #include <QUrl>
 #include <QDomDocument>
@@ -32,6 +34,34 @@
 #include "specialkey.h"
 #include "dataindex.h"
 
+static bool singleCodePoint(const QString& text, uint* codePoint)
+{
+    if (text.length() == 1)
+    {
+        *codePoint = text.at(0).unicode();
+        return true;
+    }
+
+    if (text.length() == 2 && text.at(0).isHighSurrogate() && text.at(1).isLowSurrogate())
+    {
+        *codePoint = QChar::surrogateToUcs4(text.at(0), text.at(1));
+        return true;
+    }
+
+    return false;
+}
+
+static void insertKeyIndex(QList<int>& keys, int index)
+{
+    // the keys of a character are kept in layout order
+    QList<int>::iterator it = std::lower_bound(keys.begin(), keys.end(), index);
+
+    if (it == keys.end() || *it != index)
+    {
+        keys.insert(it, index);
+    }
+}
+
 KeyboardLayout::KeyboardLayout(QObject *parent) :
     KeyboardLayoutBase(parent),
     m_associatedDataIndexKeyboardLayout(0),
@@ -40,7 +70,8 @@ KeyboardLayout::KeyboardLayout(QObject *parent) :
     m_width(0),
     m_height(0),
     m_keys(QList<AbstractKey*>()),
-    m_referenceKey(0)
+    m_referenceKey(0),
+    m_keyLookupDirty(true)
 {
 }
 
@@ -177,6 +208,80 @@ QString KeyboardLayout::allCharacters() const
     return result;
 }
 
+QList<int> KeyboardLayout::findKeys(const QString& text, int qtKey) const
+{
+    prepareKeyLookup();
+
+    QList<int> result;
+    uint codePoint;
+
+    if (singleCodePoint(text, &codePoint))
+    {
+        result = m_characterKeys.value(codePoint);
+    }
+
+    if (qtKey != -1)
+    {
+        foreach (int index, m_qtKeyKeys.value(qtKey))
+        {
+            if (!result.contains(index))
+            {
+                result.append(index);
+            }
+        }
+    }
+
+    return result;
+}
+
+QList<int> KeyboardLayout::findHighlightKeys(const QString& text, int qtKey) const
+{
+    uint codePoint;
+
+    if (qtKey != -1 || !singleCodePoint(text, &codePoint))
+        return findKeys(text, qtKey);
+
+    prepareKeyLookup();
+
+    QList<int> result;
+
+    // highlighting the key of a character includes the modifier key it needs
+    foreach (int index, m_characterKeys.value(codePoint))
+    {
+        result.append(index);
+
+        Key* const key = qobject_cast<Key*>(m_keys.at(index));
+
+        if (!key)
+            continue;
+
+        foreach (KeyChar* keyChar, key->keyChars())
+        {
+            if (keyChar->value().unicode() == codePoint && !keyChar->modifier().isEmpty())
+            {
+                const int modifierIndex = m_modifierKeys.value(keyChar->modifier(), -1);
+
+                if (modifierIndex != -1)
+                {
+                    result.append(modifierIndex);
+                }
+
+                break;
+            }
+        }
+    }
+
+    return result;
+}
+
+void KeyboardLayout::prepareKeyLookup() const
+{
+    if (m_keyLookupDirty)
+    {
+        updateKeyLookup();
+    }
+}
+
 AbstractKey* KeyboardLayout::key(int index) const
 {
     Q_ASSERT(index >= 0 && index < m_keys.count());
@@ -194,6 +299,15 @@ void KeyboardLayout::addKey(AbstractKey* key)
     key->setParent(this);
     connect(key, &AbstractKey::widthChanged, this, [=] { onKeyGeometryChanged(m_keys.count() - 1); } );
     connect(key, &AbstractKey::heightChanged, this, [=] { onKeyGeometryChanged(m_keys.count() - 1); } );
+    trackKey(key);
+
+    // an appended key doesn't move the others, it is simply added to the lookup tables
+    if (!m_keyLookupDirty)
+    {
+        m_keyCharacters.append(QList<uint>());
+        indexKey(m_keys.count() - 1);
+    }
+
     emit keyCountChanged();
     updateReferenceKey(key);
 }
@@ -204,6 +318,9 @@ void KeyboardLayout::insertKey(int index, AbstractKey* key)
     key->setParent(this);
     connect(key, &AbstractKey::widthChanged, this, [=] { onKeyGeometryChanged(m_keys.count() - 1); } );
     connect(key, &AbstractKey::heightChanged, this, [=] { onKeyGeometryChanged(m_keys.count() - 1); } );
+    trackKey(key);
+    // the keys behind the new one move, so all their indexes change
+    invalidateKeyLookup();
     emit keyCountChanged();
     updateReferenceKey(key);
 }
@@ -213,6 +330,8 @@ void KeyboardLayout::removeKey(int index)
     Q_ASSERT(index >= 0 && index < m_keys.count());
     AbstractKey* key = m_keys.at(index);
     m_keys.removeAt(index);
+    key->disconnect(this);
+    invalidateKeyLookup();
     emit keyCountChanged();
     updateReferenceKey(0);
     key->deleteLater();
@@ -225,6 +344,7 @@ void KeyboardLayout::clearKeys()
 
     qDeleteAll(m_keys);
     m_keys.clear();
+    invalidateKeyLookup();
     emit keyCountChanged();
     updateReferenceKey(0);
 }
@@ -245,6 +365,137 @@ void KeyboardLayout::onKeyGeometryChanged(int keyIndex)
     updateReferenceKey(key(keyIndex));
 }
 
+void KeyboardLayout::invalidateKeyLookup()
+{
+    m_keyLookupDirty = true;
+}
+
+void KeyboardLayout::trackKey(AbstractKey* abstractKey)
+{
+    // changes to the characters of a key only update the entries of that key,
+    // changes to special keys are rare and rebuild the lookup tables on demand
+    if (Key* const key = qobject_cast<Key*>(abstractKey))
+    {
+        foreach (KeyChar* keyChar, key->keyChars())
+        {
+            connect(keyChar, &KeyChar::valueChanged, this, [=] { updateKeyLookup(key); });
+        }
+
+        connect(key, &Key::keyCharAboutToBeAdded, this, [=](KeyChar* keyChar) {
+            connect(keyChar, &KeyChar::valueChanged, this, [=] { updateKeyLookup(key); });
+        });
+        connect(key, &Key::keyCharAdded, this, [=] { updateKeyLookup(key); });
+        connect(key, &Key::keyCharsRemoved, this, [=] { updateKeyLookup(key); });
+    }
+    else if (SpecialKey* const specialKey = qobject_cast<SpecialKey*>(abstractKey))
+    {
+        connect(specialKey, &SpecialKey::typeChanged, this, &KeyboardLayout::invalidateKeyLookup);
+        connect(specialKey, &SpecialKey::modifierIdChanged, this, &KeyboardLayout::invalidateKeyLookup);
+    }
+}
+
+void KeyboardLayout::updateKeyLookup() const
+{
+    m_characterKeys.clear();
+    m_qtKeyKeys.clear();
+    m_modifierKeys.clear();
+    m_keyCharacters.fill(QList<uint>(), m_keys.count());
+
+    for (int index = 0; index < m_keys.count(); index++)
+    {
+        indexKey(index);
+    }
+
+    m_keyLookupDirty = false;
+}
+
+void KeyboardLayout::updateKeyLookup(Key* key)
+{
+    if (m_keyLookupDirty)
+        return;
+
+    const int index = m_keys.indexOf(key);
+
+    if (index == -1)
+        return;
+
+    unindexKey(index);
+    indexKey(index);
+}
+
+void KeyboardLayout::indexKey(int index) const
+{
+    AbstractKey* const abstractKey = m_keys.at(index);
+    QList<uint>& characters = m_keyCharacters[index];
+
+    if (Key* const key = qobject_cast<Key*>(abstractKey))
+    {
+        foreach (KeyChar* keyChar, key->keyChars())
+        {
+            const uint character = keyChar->value().unicode();
+
+            if (!characters.contains(character))
+            {
+                characters.append(character);
+                insertKeyIndex(m_characterKeys[character], index);
+            }
+        }
+    }
+    else if (SpecialKey* const specialKey = qobject_cast<SpecialKey*>(abstractKey))
+    {
+        if (!specialKey->modifierId().isEmpty() && !m_modifierKeys.contains(specialKey->modifierId()))
+        {
+            m_modifierKeys.insert(specialKey->modifierId(), index);
+        }
+
+        switch (specialKey->type())
+        {
+        case SpecialKey::Tab:
+            m_qtKeyKeys[Qt::Key_Tab].append(index);
+            break;
+        case SpecialKey::Capslock:
+            m_qtKeyKeys[Qt::Key_CapsLock].append(index);
+            break;
+        case SpecialKey::Shift:
+            m_qtKeyKeys[Qt::Key_Shift].append(index);
+            break;
+        case SpecialKey::Backspace:
+            m_qtKeyKeys[Qt::Key_Backspace].append(index);
+            break;
+        case SpecialKey::Return:
+            m_qtKeyKeys[Qt::Key_Return].append(index);
+            break;
+        case SpecialKey::Space:
+            m_qtKeyKeys[Qt::Key_Space].append(index);
+            characters.append(QChar::Space);
+            insertKeyIndex(m_characterKeys[QChar::Space], index);
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+void KeyboardLayout::unindexKey(int index) const
+{
+    foreach (uint character, m_keyCharacters.at(index))
+    {
+        QHash<uint, QList<int>>::iterator it = m_characterKeys.find(character);
+
+        if (it == m_characterKeys.end())
+            continue;
+
+        it.value().removeOne(index);
+
+        if (it.value().isEmpty())
+        {
+            m_characterKeys.erase(it);
+        }
+    }
+
+    m_keyCharacters[index].clear();
+}
+
 void KeyboardLayout::updateReferenceKey(AbstractKey *testKey)
 {
     if (testKey)
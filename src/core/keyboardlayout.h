@@ -20,11 +20,15 @@
 
 #include "keyboardlayoutbase.h"
 
+#include <QHash>
+#include <QList>
 #include <QString>
 #include <QVariant>
+#include <QVector>
 
 class AbstractKey;
 class DataIndexKeyboardLayout;
+class Key;
 
 class KeyboardLayout : public KeyboardLayoutBase
 {
@@ -56,6 +60,9 @@ public:
     AbstractKey* referenceKey();
     Q_INVOKABLE void copyFrom(KeyboardLayout* source);
     Q_INVOKABLE QString allCharacters() const;
+    Q_INVOKABLE QList<int> findKeys(const QString& text, int qtKey = -1) const;
+    Q_INVOKABLE QList<int> findHighlightKeys(const QString& text, int qtKey = -1) const;
+    void prepareKeyLookup() const;
 
     QSize size() const;
     void setSize(const QSize& size);
@@ -69,8 +76,14 @@ signals:
 
 private slots:
     void onKeyGeometryChanged(int keyIndex);
+    void invalidateKeyLookup();
 
 private:
+    void trackKey(AbstractKey* key);
+    void updateKeyLookup() const;
+    void updateKeyLookup(Key* key);
+    void indexKey(int index) const;
+    void unindexKey(int index) const;
     void updateReferenceKey(AbstractKey* newKey=0);
     bool compareKeysForReference(const AbstractKey* testKey, const AbstractKey* compareKey) const;
     DataIndexKeyboardLayout* m_associatedDataIndexKeyboardLayout;
@@ -80,6 +93,11 @@ private:
     int m_height;
     QList<AbstractKey*> m_keys;
     AbstractKey* m_referenceKey;
+    mutable bool m_keyLookupDirty;
+    mutable QHash<uint, QList<int>> m_characterKeys;
+    mutable QHash<int, QList<int>> m_qtKeyKeys;
+    mutable QHash<QString, int> m_modifierKeys;
+    mutable QVector<QList<uint>> m_keyCharacters;
 
 };
 
@@ -0,0 +1,62 @@
+/*
+ *  Copyright 2026  The KTouch Developers <kde-edu@kde.org>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "keystroketimeline.h"
+
+KeystrokeTimeline::KeystrokeTimeline(int capacity)
+{
+    m_keystrokes.reserve(capacity);
+}
+
+void KeystrokeTimeline::append(qint64 timestamp, uint expected, uint typed, bool correct)
+{
+    const Keystroke keystroke = {timestamp, expected, typed, correct};
+    m_keystrokes.append(keystroke);
+}
+
+void KeystrokeTimeline::clear()
+{
+    // ### keeps the reserved capacity, so a new session doesn't reallocate
+    m_keystrokes.resize(0);
+}
+
+int KeystrokeTimeline::count() const
+{
+    return m_keystrokes.count();
+}
+
+bool KeystrokeTimeline::isEmpty() const
+{
+    return m_keystrokes.isEmpty();
+}
+
+const Keystroke& KeystrokeTimeline::at(int index) const
+{
+    Q_ASSERT(index >= 0 && index < m_keystrokes.count());
+    return m_keystrokes.at(index);
+}
+
+const Keystroke& KeystrokeTimeline::last() const
+{
+    Q_ASSERT(!m_keystrokes.isEmpty());
+    return m_keystrokes.last();
+}
+
+const Keystroke* KeystrokeTimeline::constData() const
+{
+    return m_keystrokes.constData();
+}
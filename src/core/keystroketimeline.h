@@ -0,0 +1,50 @@
+/*
+ *  Copyright 2026  The KTouch Developers <kde-edu@kde.org>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEYSTROKETIMELINE_H
+#define KEYSTROKETIMELINE_H
+
+#include <QtGlobal>
+#include <QVector>
+
+struct Keystroke
+{
+    // nanoseconds since the start of the training session
+    qint64 timestamp;
+    uint expected;
+    uint typed;
+    bool correct;
+};
+
+Q_DECLARE_TYPEINFO(Keystroke, Q_PRIMITIVE_TYPE);
+
+class KeystrokeTimeline
+{
+public:
+    explicit KeystrokeTimeline(int capacity = 4096);
+    void append(qint64 timestamp, uint expected, uint typed, bool correct);
+    void clear();
+    int count() const;
+    bool isEmpty() const;
+    const Keystroke& at(int index) const;
+    const Keystroke& last() const;
+    const Keystroke* constData() const;
+private:
+    QVector<Keystroke> m_keystrokes;
+};
+
+#endif // KEYSTROKETIMELINE_H
@@ -0,0 +1,164 @@
+/*
+ *  Copyright 2026  The KTouch Developers <kde-edu@kde.org>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "ngramstats.h"
+
+// code points need 21 bits, so up to three of them fit into the 64 bit key
+static const int CodePointBits = 21;
+
+double NGramStats::Entry::variance() const
+{
+    return count > 1? m2 / (count - 1): 0.0;
+}
+
+NGramStats::NGramStats(int order, int capacity) :
+    m_order(order),
+    m_size(0),
+    m_droppedCount(0)
+{
+    Q_ASSERT(order >= 1 && order <= 3);
+
+    int tableSize = 1;
+    while (tableSize < capacity)
+        tableSize <<= 1;
+
+    m_mask = quint64(tableSize - 1);
+    m_table.resize(tableSize);
+    clear();
+}
+
+int NGramStats::order() const
+{
+    return m_order;
+}
+
+int NGramStats::size() const
+{
+    return m_size;
+}
+
+int NGramStats::droppedCount() const
+{
+    return m_droppedCount;
+}
+
+void NGramStats::add(const uint* codePoints, double interval)
+{
+    const quint64 key = pack(codePoints);
+    const int index = slot(key);
+
+    if (index == -1)
+    {
+        m_droppedCount++;
+        return;
+    }
+
+    Entry& entry = m_table[index];
+
+    if (entry.count == 0)
+    {
+        entry.key = key;
+        m_size++;
+    }
+
+    entry.count++;
+    const double delta = interval - entry.mean;
+    entry.mean += delta / entry.count;
+    entry.m2 += delta * (interval - entry.mean);
+}
+
+void NGramStats::clear()
+{
+    const Entry empty = {0, 0, 0.0, 0.0};
+    m_table.fill(empty);
+    m_size = 0;
+    m_droppedCount = 0;
+}
+
+const NGramStats::Entry* NGramStats::find(const uint* codePoints) const
+{
+    const quint64 key = pack(codePoints);
+    const int index = slot(key);
+
+    if (index == -1 || m_table.at(index).count == 0)
+        return 0;
+
+    return &m_table.at(index);
+}
+
+QVector<NGramStats::Entry> NGramStats::entries() const
+{
+    QVector<Entry> result;
+    result.reserve(m_size);
+
+    for (const Entry& entry: m_table)
+    {
+        if (entry.count > 0)
+        {
+            result.append(entry);
+        }
+    }
+
+    return result;
+}
+
+QString NGramStats::ngram(const Entry& entry) const
+{
+    uint codePoints[3];
+
+    for (int i = 0; i < m_order; i++)
+    {
+        const int shift = (m_order - 1 - i) * CodePointBits;
+        codePoints[i] = uint((entry.key >> shift) & ((Q_UINT64_C(1) << CodePointBits) - 1));
+    }
+
+    return QString::fromUcs4(codePoints, m_order);
+}
+
+quint64 NGramStats::pack(const uint* codePoints) const
+{
+    quint64 key = 0;
+
+    for (int i = 0; i < m_order; i++)
+    {
+        key = (key << CodePointBits) | (codePoints[i] & ((1u << CodePointBits) - 1));
+    }
+
+    return key;
+}
+
+int NGramStats::slot(quint64 key) const
+{
+    // linear probing, keep the load factor at 3/4 so probe sequences stay short
+    const bool full = m_size >= int(m_mask + 1) / 4 * 3;
+    quint64 index = (key * Q_UINT64_C(0x9E3779B97F4A7C15)) >> 32 & m_mask;
+
+    for (quint64 probe = 0; probe <= m_mask; probe++)
+    {
+        const Entry& entry = m_table.at(int(index));
+
+        if (entry.count == 0)
+            return full? -1: int(index);
+
+        if (entry.key == key)
+            return int(index);
+
+        index = (index + 1) & m_mask;
+    }
+
+    return -1;
+}
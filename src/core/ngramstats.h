@@ -0,0 +1,59 @@
+/*
+ *  Copyright 2026  The KTouch Developers <kde-edu@kde.org>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef NGRAMSTATS_H
+#define NGRAMSTATS_H
+
+#include <QtGlobal>
+#include <QString>
+#include <QVector>
+
+class NGramStats
+{
+public:
+    struct Entry
+    {
+        quint64 key;
+        quint32 count;
+        double mean;
+        double m2;
+        double variance() const;
+    };
+
+    NGramStats(int order, int capacity);
+    int order() const;
+    int size() const;
+    int droppedCount() const;
+    void add(const uint* codePoints, double interval);
+    void clear();
+    const Entry* find(const uint* codePoints) const;
+    QVector<Entry> entries() const;
+    QString ngram(const Entry& entry) const;
+
+private:
+    quint64 pack(const uint* codePoints) const;
+    int slot(quint64 key) const;
+    int m_order;
+    int m_size;
+    int m_droppedCount;
+    quint64 m_mask;
+    QVector<Entry> m_table;
+};
+
+Q_DECLARE_TYPEINFO(NGramStats::Entry, Q_PRIMITIVE_TYPE);
+
+#endif // NGRAMSTATS_H
@@ -28,6 +28,7 @@
 #include "core/course.h"
 #include "core/lesson.h"
 #include "core/keyboardlayout.h"
+#include "core/sessionjournal.h"
 #include "core/trainingstats.h"
 
 ProfileDataAccess::ProfileDataAccess(QObject* parent) :
@@ -309,56 +310,166 @@ void ProfileDataAccess::loadReferenceTrainingStats(TrainingStats* stats, Profile
         return;
     }
 
-    QMap<QString, int> errorMap;
+    QSqlQuery confusionSelectQuery;
 
+    confusionSelectQuery.prepare(QStringLiteral("SELECT expected_character, typed_character, count FROM training_stats_confusions WHERE stats_id = ?"));
+
+    confusionSelectQuery.bindValue(0, statsId);
+
+    if (!confusionSelectQuery.exec())
+    {
+        qWarning() <<  confusionSelectQuery.lastError().text();
+        raiseError(confusionSelectQuery.lastError());
+        return;
+    }
+
+    ConfusionMatrix confusionMatrix;
+
+    while (confusionSelectQuery.next())
+    {
+        const uint expected = ConfusionMatrix::codePoint(confusionSelectQuery.value(0).toString());
+        const uint typed = ConfusionMatrix::codePoint(confusionSelectQuery.value(1).toString());
+        confusionMatrix.add(expected, typed, confusionSelectQuery.value(2).toInt());
+    }
+
+    // errors saved without the character typed instead are kept as such
     while (errorSelectQuery.next())
     {
-        const QString character = errorSelectQuery.value(0).toString();
-        const int errorCount = errorSelectQuery.value(1).toInt();
-        errorMap.insert(character, errorCount);
+        const uint expected = ConfusionMatrix::codePoint(errorSelectQuery.value(0).toString());
+        const int unknownErrors = errorSelectQuery.value(1).toInt() - confusionMatrix.errorCount(expected);
+
+        if (unknownErrors > 0)
+        {
+            confusionMatrix.add(expected, 0, unknownErrors);
+        }
     }
 
-    stats->setErrorMap(errorMap);
+    stats->setConfusionMatrix(confusionMatrix);
     stats->setIsValid(true);
 }
 
-void ProfileDataAccess::saveTrainingStats(TrainingStats* stats, Profile* profile, const QString& courseId, const QString& lessonId)
+void ProfileDataAccess::saveTrainingStats(TrainingStats* stats, Profile* profile, const QString& courseId, const QString& lessonId, const QString& sessionId)
+{
+    saveTrainingStats(stats, profile->id(), courseId, lessonId, QDateTime::currentMSecsSinceEpoch(), sessionId);
+}
+
+void ProfileDataAccess::recoverTrainingStats()
+{
+    const QList<SessionCheckpoint> checkpoints = SessionJournal::pendingSessions();
+
+    // a journal holding only finished sessions has nothing left to recover
+    if (checkpoints.isEmpty())
+    {
+        SessionJournal::clear();
+        return;
+    }
+
+    bool success = true;
+
+    foreach (const SessionCheckpoint& checkpoint, checkpoints)
+    {
+        bool ok;
+
+        // the stats of a session are saved before it is ended in the journal, a
+        // crash in between leaves a session behind that is already in the database
+        if (hasTrainingStats(checkpoint.sessionId, &ok) || !ok)
+        {
+            success = ok && success;
+            continue;
+        }
+
+        TrainingStats stats;
+        ConfusionMatrix confusionMatrix;
+
+        foreach (const ConfusionMatrix::Cell& cell, checkpoint.confusions)
+        {
+            confusionMatrix.add(cell.expected, cell.typed, cell.count);
+        }
+
+        stats.setCharactersTyped(checkpoint.charactersTyped);
+        stats.setErrorCount(checkpoint.errorCount);
+        stats.setElapsedTime(checkpoint.elapsedTime);
+        stats.setConfusionMatrix(confusionMatrix);
+
+        success = saveTrainingStats(&stats, checkpoint.profileId, checkpoint.courseId, checkpoint.lessonId, checkpoint.date, checkpoint.sessionId) && success;
+    }
+
+    if (success)
+    {
+        SessionJournal::clear();
+    }
+}
+
+bool ProfileDataAccess::hasTrainingStats(const QString& sessionId, bool* ok)
 {
+    *ok = false;
+
     QSqlDatabase db = database();
 
     if (!db.isOpen())
-        return;
+        return false;
+
+    QSqlQuery query(db);
+
+    if (!query.prepare(QStringLiteral("SELECT COUNT(*) FROM training_stats WHERE session_id = ?")))
+    {
+        qWarning() << query.lastError().text();
+        raiseError(query.lastError());
+        return false;
+    }
+
+    query.bindValue(0, sessionId);
+
+    if (!query.exec())
+    {
+        qWarning() << query.lastError().text();
+        raiseError(query.lastError());
+        return false;
+    }
+
+    *ok = true;
+
+    return query.next() && query.value(0).toInt() > 0;
+}
+
+bool ProfileDataAccess::saveTrainingStats(TrainingStats* stats, int profileId, const QString& courseId, const QString& lessonId, qint64 date, const QString& sessionId)
+{
+    QSqlDatabase db = database();
+
+    if (!db.isOpen())
+        return false;
 
     if (!db.transaction())
     {
         qWarning() <<  db.lastError().text();
         raiseError(db.lastError());
-        return;
+        return false;
     }
     QSqlQuery addQuery(db);
 
-    if (!addQuery.prepare(QStringLiteral("INSERT INTO training_stats (profile_id, course_id, lesson_id, date, characters_typed, error_count, elapsed_time) VALUES (?, ?, ?, ?, ?, ?, ?)")))
+    if (!addQuery.prepare(QStringLiteral("INSERT INTO training_stats (profile_id, course_id, lesson_id, date, characters_typed, error_count, elapsed_time, session_id) VALUES (?, ?, ?, ?, ?, ?, ?, ?)")))
     {
         qWarning() <<  addQuery.lastError().text();
         raiseError(addQuery.lastError());
         db.rollback();
-        return;
+        return false;
     }
-    addQuery.bindValue(0, profile->id());
+    addQuery.bindValue(0, profileId);
     addQuery.bindValue(1, courseId);
     addQuery.bindValue(2, lessonId);
-    addQuery.bindValue(3, QDateTime::currentMSecsSinceEpoch());
+    addQuery.bindValue(3, date);
     addQuery.bindValue(4, stats->charactesTyped());
     addQuery.bindValue(5, stats->errorCount());
     const int rawElapsedTime = QTime(0, 0).msecsTo(stats->elapsedTime());
     addQuery.bindValue(6, rawElapsedTime);
+    addQuery.bindValue(7, sessionId.isEmpty()? QVariant(QVariant::String): QVariant(sessionId));
 
     if (!addQuery.exec())
     {
         qWarning() <<  addQuery.lastError().text();
         raiseError(addQuery.lastError());
         db.rollback();
-        return;
+        return false;
     }
 
     QSqlQuery idQuery = db.exec(QStringLiteral("SELECT last_insert_rowid()"));
@@ -368,7 +479,7 @@ void ProfileDataAccess::saveTrainingStats(TrainingStats* stats, Profile* profile
         qWarning() << db.lastError().text();
         raiseError(db.lastError());
         db.rollback();
-        return;
+        return false;
     }
 
     idQuery.next();
@@ -381,7 +492,7 @@ void ProfileDataAccess::saveTrainingStats(TrainingStats* stats, Profile* profile
         qWarning() <<  addErrorsQuery.lastError().text();
         raiseError(addErrorsQuery.lastError());
         db.rollback();
-        return;
+        return false;
     }
 
     QMapIterator<QString, int> errorIterator(stats->errorMap());
@@ -397,7 +508,100 @@ void ProfileDataAccess::saveTrainingStats(TrainingStats* stats, Profile* profile
             qWarning() <<  addErrorsQuery.lastError().text();
             raiseError(addErrorsQuery.lastError());
             db.rollback();
-            return;
+            return false;
+        }
+    }
+
+    QSqlQuery addConfusionsQuery(db);
+
+    if (!addConfusionsQuery.prepare(QStringLiteral("INSERT INTO training_stats_confusions (stats_id, expected_character, typed_character, count) VALUES (?, ?, ?, ?)")))
+    {
+        qWarning() <<  addConfusionsQuery.lastError().text();
+        raiseError(addConfusionsQuery.lastError());
+        db.rollback();
+        return false;
+    }
+
+    foreach (const ConfusionMatrix::Cell& cell, stats->confusionMatrix().cells())
+    {
+        if (cell.typed == 0)
+            continue;
+
+        addConfusionsQuery.bindValue(0, statsId);
+        addConfusionsQuery.bindValue(1, ConfusionMatrix::character(cell.expected));
+        addConfusionsQuery.bindValue(2, ConfusionMatrix::character(cell.typed));
+        addConfusionsQuery.bindValue(3, cell.count);
+
+        if (!addConfusionsQuery.exec())
+        {
+            qWarning() <<  addConfusionsQuery.lastError().text();
+            raiseError(addConfusionsQuery.lastError());
+            db.rollback();
+            return false;
+        }
+    }
+
+    QSqlQuery addNGramsQuery(db);
+
+    if (!addNGramsQuery.prepare(QStringLiteral("INSERT INTO training_stats_ngrams (stats_id, ngram, count, mean_interval, interval_variance) VALUES (?, ?, ?, ?, ?)")))
+    {
+        qWarning() <<  addNGramsQuery.lastError().text();
+        raiseError(addNGramsQuery.lastError());
+        db.rollback();
+        return false;
+    }
+
+    const NGramStats* const ngramTables[] = {&stats->bigramStats(), &stats->trigramStats()};
+
+    for (const NGramStats* ngramStats: ngramTables)
+    {
+        foreach (const NGramStats::Entry& entry, ngramStats->entries())
+        {
+            addNGramsQuery.bindValue(0, statsId);
+            addNGramsQuery.bindValue(1, ngramStats->ngram(entry));
+            addNGramsQuery.bindValue(2, entry.count);
+            addNGramsQuery.bindValue(3, entry.mean);
+            addNGramsQuery.bindValue(4, entry.variance());
+
+            if (!addNGramsQuery.exec())
+            {
+                qWarning() <<  addNGramsQuery.lastError().text();
+                raiseError(addNGramsQuery.lastError());
+                db.rollback();
+                return false;
+            }
+        }
+    }
+
+    QSqlQuery addFingersQuery(db);
+
+    if (!addFingersQuery.prepare(QStringLiteral("INSERT INTO training_stats_fingers (stats_id, finger, keystrokes, error_count, mean_interval) VALUES (?, ?, ?, ?, ?)")))
+    {
+        qWarning() <<  addFingersQuery.lastError().text();
+        raiseError(addFingersQuery.lastError());
+        db.rollback();
+        return false;
+    }
+
+    for (int finger = 0; finger < FingerStats::FingerCount; finger++)
+    {
+        const FingerStats::Finger& fingerStats = stats->fingerStats().at(finger);
+
+        if (fingerStats.keystrokes == 0)
+            continue;
+
+        addFingersQuery.bindValue(0, statsId);
+        addFingersQuery.bindValue(1, finger);
+        addFingersQuery.bindValue(2, fingerStats.keystrokes);
+        addFingersQuery.bindValue(3, fingerStats.errors);
+        addFingersQuery.bindValue(4, fingerStats.meanInterval);
+
+        if (!addFingersQuery.exec())
+        {
+            qWarning() <<  addFingersQuery.lastError().text();
+            raiseError(addFingersQuery.lastError());
+            db.rollback();
+            return false;
         }
     }
 
@@ -406,8 +610,10 @@ void ProfileDataAccess::saveTrainingStats(TrainingStats* stats, Profile* profile
         qWarning() <<  db.lastError().text();
         raiseError(db.lastError());
         db.rollback();
-        return;
+        return false;
     }
+
+    return true;
 }
 
 QString ProfileDataAccess::courseProgress(Profile* profile, const QString& courseId, CourseProgressType type)
@@ -850,6 +1056,34 @@ QSqlQuery ProfileDataAccess::learningProgressQuery(Profile* profile, Course* cou
     return query;
 }
 
+QSqlQuery ProfileDataAccess::errorCountsQuery(Profile* profile)
+{
+    QSqlDatabase db = database();
+
+    if (!profile)
+        return QSqlQuery();
+
+    if (!db.isOpen())
+        return QSqlQuery();
+
+    QSqlQuery query(db);
+
+    query.prepare(QStringLiteral("SELECT training_stats_errors.character, SUM(training_stats_errors.count) FROM training_stats_errors "
+                                 "INNER JOIN training_stats ON training_stats_errors.stats_id = training_stats.id "
+                                 "WHERE training_stats.profile_id = ? GROUP BY training_stats_errors.character"));
+
+    query.bindValue(0, profile->id());
+
+    if (!query.exec())
+    {
+        qWarning() <<  query.lastError().text();
+        raiseError(query.lastError());
+        return QSqlQuery();
+    }
+
+    return query;
+}
+
 int ProfileDataAccess::findCourseProgressId(Profile* profile, const QString& courseId, CourseProgressType type, bool* ok)
 {
     *ok = false;
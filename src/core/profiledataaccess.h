@@ -55,7 +55,8 @@ public:
     Q_INVOKABLE int indexOfProfile(Profile* profile);
 
     Q_INVOKABLE void loadReferenceTrainingStats(TrainingStats* stats, Profile* profile, const QString& courseId, const QString& lessonId);
-    Q_INVOKABLE void saveTrainingStats(TrainingStats* stats, Profile* profile, const QString& courseId, const QString& lessonId);
+    Q_INVOKABLE void saveTrainingStats(TrainingStats* stats, Profile* profile, const QString& courseId, const QString& lessonId, const QString& sessionId = QString());
+    Q_INVOKABLE void recoverTrainingStats();
 
     Q_INVOKABLE QString courseProgress(Profile* profile, const QString& courseId, CourseProgressType type);
     Q_INVOKABLE void saveCourseProgress(const QString& lessonId, Profile* profile, const QString& courseId, CourseProgressType type);
@@ -70,11 +71,14 @@ public:
     Q_INVOKABLE bool deleteCustomLesson(const QString& id);
 
     QSqlQuery learningProgressQuery(Profile* profile, Course* courseFilter = 0, Lesson* lessonFilter = 0);
+    QSqlQuery errorCountsQuery(Profile* profile);
 
 signals:
     void profileCountChanged();
 
 private:
+    bool saveTrainingStats(TrainingStats* stats, int profileId, const QString& courseId, const QString& lessonId, qint64 date, const QString& sessionId);
+    bool hasTrainingStats(const QString& sessionId, bool* ok);
     int findCourseProgressId(Profile* profile, const QString &courseId, CourseProgressType type, bool* ok);
     QList<Profile*> m_profiles;
 };
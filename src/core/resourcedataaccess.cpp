@@ -168,6 +168,7 @@ bool ResourceDataAccess::loadKeyboardLayout(const QString &path, KeyboardLayout*
         target->addKey(abstractKey);
     }
 
+    target->prepareKeyLookup();
     target->setIsValid(true);
     return true;
 }
@@ -0,0 +1,317 @@
+/*
+ *  Copyright 2026  The KTouch Developers <kde-edu@kde.org>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "sessionjournal.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QHash>
+#include <QStandardPaths>
+#include <QThread>
+#include <QTimer>
+#include <QUuid>
+
+#include "core/profile.h"
+#include "core/sessionjournalwriter.h"
+#include "core/trainingstats.h"
+
+// checkpoints are taken at the latest after this many keystrokes or milliseconds
+static const int CheckpointKeystrokes = 50;
+static const int CheckpointInterval = 5000;
+
+static QDataStream& operator<<(QDataStream& stream, const ConfusionMatrix::Cell& cell)
+{
+    return stream << quint32(cell.expected) << quint32(cell.typed) << qint32(cell.count);
+}
+
+static QDataStream& operator>>(QDataStream& stream, ConfusionMatrix::Cell& cell)
+{
+    quint32 expected;
+    quint32 typed;
+    qint32 count;
+    stream >> expected >> typed >> count;
+    cell.expected = expected;
+    cell.typed = typed;
+    cell.count = count;
+    return stream;
+}
+
+SessionJournal::SessionJournal(QObject* parent) :
+    QObject(parent),
+    m_writerThread(new QThread(this)),
+    m_writer(new SessionJournalWriter(journalPath())),
+    m_journalOpen(false),
+    m_earlierSessionsPending(true),
+    m_commitTimer(new QTimer(this)),
+    m_profileId(-1),
+    m_pendingKeystrokes(0),
+    m_lastKeystrokeCount(0)
+{
+    m_commitTimer->setSingleShot(true);
+    connect(m_commitTimer, &QTimer::timeout, this, &SessionJournal::writeCheckpoint);
+
+    m_writer->moveToThread(m_writerThread);
+    m_writerThread->start();
+}
+
+SessionJournal::~SessionJournal()
+{
+    // a session still open on a regular shutdown was abandoned by the user
+    discard();
+
+    // wait until everything queued so far has been written
+    QMetaObject::invokeMethod(m_writer, "close", Qt::BlockingQueuedConnection, Q_ARG(bool, false));
+    m_writerThread->quit();
+    m_writerThread->wait();
+    delete m_writer;
+}
+
+TrainingStats* SessionJournal::trainingStats() const
+{
+    return m_trainingStats;
+}
+
+void SessionJournal::setTrainingStats(TrainingStats* trainingStats)
+{
+    if (trainingStats != m_trainingStats)
+    {
+        if (m_trainingStats)
+        {
+            m_trainingStats->disconnect(this);
+        }
+
+        m_trainingStats = trainingStats;
+        m_lastKeystrokeCount = m_trainingStats? m_trainingStats->keystrokeCount(): 0;
+
+        if (m_trainingStats)
+        {
+            connect(m_trainingStats.data(), &TrainingStats::keystrokesChanged, this, &SessionJournal::onKeystroke);
+        }
+
+        emit trainingStatsChanged();
+    }
+}
+
+void SessionJournal::begin(Profile* profile, const QString& courseId, const QString& lessonId)
+{
+    discard();
+
+    if (!profile)
+        return;
+
+    // sessions of a crashed run stay in the journal until they have been
+    // recovered, which removes the journal
+    if (m_earlierSessionsPending)
+    {
+        m_earlierSessionsPending = QFileInfo::exists(journalPath());
+    }
+
+    m_sessionId = QUuid::createUuid().toRfc4122();
+    m_profileId = profile->id();
+    m_courseId = courseId;
+    m_lessonId = lessonId;
+    m_pendingKeystrokes = 0;
+    m_lastKeystrokeCount = m_trainingStats? m_trainingStats->keystrokeCount(): 0;
+}
+
+QString SessionJournal::sessionId() const
+{
+    // saved along with the training stats, so recovery can tell which sessions made it into the database
+    return m_sessionId.isEmpty()? QString(): QUuid::fromRfc4122(m_sessionId).toString();
+}
+
+void SessionJournal::commit()
+{
+    // the session is in the database now, nothing is left to recover
+    endSession();
+}
+
+void SessionJournal::discard()
+{
+    endSession();
+}
+
+QString SessionJournal::journalPath()
+{
+    return QDir(QStandardPaths::writableLocation(QStandardPaths::DataLocation)).filePath(QStringLiteral("training-journal"));
+}
+
+QList<SessionCheckpoint> SessionJournal::pendingSessions()
+{
+    QFile file(journalPath());
+    QList<SessionCheckpoint> result;
+
+    if (!file.open(QIODevice::ReadOnly))
+        return result;
+
+    QDataStream fileStream(&file);
+    QHash<QByteArray, int> sessionIndexes;
+
+    while (!fileStream.atEnd())
+    {
+        quint32 size;
+        quint16 checksum;
+        fileStream >> size >> checksum;
+
+        if (fileStream.status() != QDataStream::Ok || size > quint32(file.bytesAvailable()))
+            break;
+
+        const QByteArray payload = file.read(size);
+
+        // a torn write at the end of the journal is expected after a crash
+        if (payload.size() != int(size) || qChecksum(payload.constData(), size) != checksum)
+            break;
+
+        QDataStream stream(payload);
+        stream.setVersion(QDataStream::Qt_5_9);
+        quint8 type;
+        QByteArray sessionId;
+        stream >> type >> sessionId;
+
+        if (type == CheckpointRecord)
+        {
+            SessionCheckpoint checkpoint;
+            checkpoint.sessionId = QUuid::fromRfc4122(sessionId).toString();
+            qint32 profileId;
+            qint32 charactersTyped;
+            qint32 errorCount;
+            stream >> profileId >> checkpoint.courseId >> checkpoint.lessonId >> checkpoint.date
+                   >> charactersTyped >> errorCount >> checkpoint.elapsedTime >> checkpoint.confusions;
+
+            if (stream.status() != QDataStream::Ok)
+                break;
+
+            checkpoint.profileId = profileId;
+            checkpoint.charactersTyped = charactersTyped;
+            checkpoint.errorCount = errorCount;
+
+            if (sessionIndexes.contains(sessionId))
+            {
+                result[sessionIndexes.value(sessionId)] = checkpoint;
+            }
+            else
+            {
+                sessionIndexes.insert(sessionId, result.count());
+                result.append(checkpoint);
+            }
+        }
+        else if (type == EndRecord && sessionIndexes.contains(sessionId))
+        {
+            result[sessionIndexes.value(sessionId)].sessionId.clear();
+        }
+    }
+
+    for (int i = result.count() - 1; i >= 0; i--)
+    {
+        if (result.at(i).sessionId.isEmpty() || result.at(i).charactersTyped + result.at(i).errorCount == 0)
+        {
+            result.removeAt(i);
+        }
+    }
+
+    return result;
+}
+
+void SessionJournal::clear()
+{
+    QFile::remove(journalPath());
+}
+
+void SessionJournal::onKeystroke()
+{
+    if (m_sessionId.isEmpty() || !m_trainingStats)
+        return;
+
+    // batched input announces several keystrokes at once
+    const int keystrokeCount = m_trainingStats->keystrokeCount();
+    m_pendingKeystrokes += qMax(0, keystrokeCount - m_lastKeystrokeCount);
+    m_lastKeystrokeCount = keystrokeCount;
+
+    if (m_pendingKeystrokes == 0)
+        return;
+
+    // group commit: the journal is written from the event loop, never from the keystroke itself
+    if (m_pendingKeystrokes >= CheckpointKeystrokes)
+    {
+        m_commitTimer->start(0);
+    }
+    else if (!m_commitTimer->isActive())
+    {
+        m_commitTimer->start(CheckpointInterval);
+    }
+}
+
+void SessionJournal::writeCheckpoint()
+{
+    if (m_sessionId.isEmpty() || !m_trainingStats || m_pendingKeystrokes == 0)
+        return;
+
+    QByteArray payload;
+    QDataStream stream(&payload, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_9);
+    stream << quint8(CheckpointRecord) << m_sessionId << qint32(m_profileId) << m_courseId << m_lessonId
+           << QDateTime::currentMSecsSinceEpoch() << qint32(m_trainingStats->charactesTyped())
+           << qint32(m_trainingStats->errorCount()) << m_trainingStats->elapsedMSecs()
+           << m_trainingStats->confusionMatrix().cells();
+
+    writeRecord(payload);
+    m_pendingKeystrokes = 0;
+}
+
+void SessionJournal::endSession()
+{
+    if (m_sessionId.isEmpty())
+        return;
+
+    m_commitTimer->stop();
+
+    if (m_journalOpen)
+    {
+        // with nothing else left to recover the journal goes away with the session
+        if (!m_earlierSessionsPending)
+        {
+            QMetaObject::invokeMethod(m_writer, "close", Qt::QueuedConnection, Q_ARG(bool, true));
+        }
+        else
+        {
+            QByteArray payload;
+            QDataStream stream(&payload, QIODevice::WriteOnly);
+            stream.setVersion(QDataStream::Qt_5_9);
+            stream << quint8(EndRecord) << m_sessionId;
+            writeRecord(payload);
+            QMetaObject::invokeMethod(m_writer, "close", Qt::QueuedConnection, Q_ARG(bool, false));
+        }
+
+        m_journalOpen = false;
+    }
+
+    m_sessionId.clear();
+}
+
+void SessionJournal::writeRecord(const QByteArray& payload)
+{
+    QByteArray record;
+    QDataStream stream(&record, QIODevice::WriteOnly);
+    stream << quint32(payload.size()) << qChecksum(payload.constData(), uint(payload.size()));
+    record.append(payload);
+
+    // writing and syncing happen in the writer thread, in the order queued here
+    QMetaObject::invokeMethod(m_writer, "writeRecord", Qt::QueuedConnection, Q_ARG(QByteArray, record));
+    m_journalOpen = true;
+}
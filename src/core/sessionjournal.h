@@ -0,0 +1,97 @@
+/*
+ *  Copyright 2026  The KTouch Developers <kde-edu@kde.org>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SESSIONJOURNAL_H
+#define SESSIONJOURNAL_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QList>
+#include <QPointer>
+#include <QString>
+#include <QVector>
+
+#include "core/confusionmatrix.h"
+
+class QThread;
+class QTimer;
+
+class Profile;
+class SessionJournalWriter;
+class TrainingStats;
+
+struct SessionCheckpoint
+{
+    QString sessionId;
+    int profileId;
+    QString courseId;
+    QString lessonId;
+    qint64 date;
+    int charactersTyped;
+    int errorCount;
+    quint64 elapsedTime;
+    QVector<ConfusionMatrix::Cell> confusions;
+};
+
+class SessionJournal : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(TrainingStats* trainingStats READ trainingStats WRITE setTrainingStats NOTIFY trainingStatsChanged)
+
+public:
+    explicit SessionJournal(QObject* parent = 0);
+    ~SessionJournal();
+    TrainingStats* trainingStats() const;
+    void setTrainingStats(TrainingStats* trainingStats);
+    Q_INVOKABLE void begin(Profile* profile, const QString& courseId, const QString& lessonId);
+    Q_INVOKABLE QString sessionId() const;
+    Q_INVOKABLE void commit();
+    Q_INVOKABLE void discard();
+    static QString journalPath();
+    static QList<SessionCheckpoint> pendingSessions();
+    static void clear();
+
+signals:
+    void trainingStatsChanged();
+
+private slots:
+    void onKeystroke();
+    void writeCheckpoint();
+
+private:
+    enum RecordType {
+        CheckpointRecord = 1,
+        EndRecord
+    };
+
+    void endSession();
+    void writeRecord(const QByteArray& payload);
+    QPointer<TrainingStats> m_trainingStats;
+    QThread* m_writerThread;
+    SessionJournalWriter* m_writer;
+    bool m_journalOpen;
+    bool m_earlierSessionsPending;
+    QTimer* m_commitTimer;
+    QByteArray m_sessionId;
+    int m_profileId;
+    QString m_courseId;
+    QString m_lessonId;
+    int m_pendingKeystrokes;
+    int m_lastKeystrokeCount;
+};
+
+#endif // SESSIONJOURNAL_H
@@ -0,0 +1,67 @@
+/*
+ *  Copyright 2026  The KTouch Developers <kde-edu@kde.org>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "sessionjournalwriter.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+SessionJournalWriter::SessionJournalWriter(const QString& path, QObject* parent) :
+    QObject(parent),
+    m_file(path, this)
+{
+}
+
+void SessionJournalWriter::writeRecord(const QByteArray& record)
+{
+    if (!m_file.isOpen())
+    {
+        QDir().mkpath(QFileInfo(m_file.fileName()).path());
+
+        if (!m_file.open(QIODevice::WriteOnly | QIODevice::Append))
+        {
+            qWarning() << "can't open training journal" << m_file.errorString();
+            return;
+        }
+    }
+
+    m_file.write(record);
+    m_file.flush();
+
+#ifdef Q_OS_WIN
+    _commit(m_file.handle());
+#else
+    fsync(m_file.handle());
+#endif
+}
+
+void SessionJournalWriter::close(bool remove)
+{
+    m_file.close();
+
+    if (remove)
+    {
+        m_file.remove();
+    }
+}
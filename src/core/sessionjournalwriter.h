@@ -0,0 +1,42 @@
+/*
+ *  Copyright 2026  The KTouch Developers <kde-edu@kde.org>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SESSIONJOURNALWRITER_H
+#define SESSIONJOURNALWRITER_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+
+// owns the journal file, lives in a thread of its own so syncing never blocks the user interface
+class SessionJournalWriter : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SessionJournalWriter(const QString& path, QObject* parent = 0);
+
+public slots:
+    void writeRecord(const QByteArray& record);
+    void close(bool remove);
+
+private:
+    QFile m_file;
+};
+
+#endif // SESSIONJOURNALWRITER_H
@@ -0,0 +1,128 @@
+/*
+ *  Copyright 2026  The KTouch Developers <kde-edu@kde.org>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "slidingwindowstats.h"
+
+SlidingWindowStats::SlidingWindowStats(qint64 windowNSecs, int windowKeystrokes) :
+    m_windowNSecs(windowNSecs),
+    m_timestamps(256),
+    m_timestampsHead(0),
+    m_timestampsCount(0),
+    m_keystrokes(qMax(1, windowKeystrokes)),
+    m_keystrokesHead(0),
+    m_keystrokesCount(0),
+    m_errors(0)
+{
+}
+
+qint64 SlidingWindowStats::windowNSecs() const
+{
+    return m_windowNSecs;
+}
+
+int SlidingWindowStats::windowKeystrokes() const
+{
+    return m_keystrokes.size();
+}
+
+void SlidingWindowStats::add(qint64 timestamp, bool correct)
+{
+    // accuracy window: overwrite the oldest keystroke once the window is full
+    const int capacity = m_keystrokes.size();
+    const int slot = (m_keystrokesHead + m_keystrokesCount) % capacity;
+
+    if (m_keystrokesCount == capacity)
+    {
+        if (!m_keystrokes.at(m_keystrokesHead))
+            m_errors--;
+        m_keystrokesHead = (m_keystrokesHead + 1) % capacity;
+    }
+    else
+    {
+        m_keystrokesCount++;
+    }
+
+    m_keystrokes[slot] = correct;
+
+    if (!correct)
+    {
+        m_errors++;
+        expire(timestamp);
+        return;
+    }
+
+    // speed window: only correct characters count
+    expire(timestamp);
+
+    if (m_timestampsCount == m_timestamps.size())
+    {
+        // only happens for bursts of more than 256 characters within the window
+        QVector<qint64> timestamps(2 * m_timestamps.size());
+
+        for (int i = 0; i < m_timestampsCount; i++)
+        {
+            timestamps[i] = m_timestamps.at((m_timestampsHead + i) % m_timestamps.size());
+        }
+
+        m_timestamps = timestamps;
+        m_timestampsHead = 0;
+    }
+
+    m_timestamps[(m_timestampsHead + m_timestampsCount) % m_timestamps.size()] = timestamp;
+    m_timestampsCount++;
+}
+
+void SlidingWindowStats::expire(qint64 now)
+{
+    while (m_timestampsCount > 0 && now - m_timestamps.at(m_timestampsHead) > m_windowNSecs)
+    {
+        m_timestampsHead = (m_timestampsHead + 1) % m_timestamps.size();
+        m_timestampsCount--;
+    }
+}
+
+void SlidingWindowStats::clear()
+{
+    m_timestampsHead = 0;
+    m_timestampsCount = 0;
+    m_keystrokesHead = 0;
+    m_keystrokesCount = 0;
+    m_errors = 0;
+}
+
+int SlidingWindowStats::recentCharacters() const
+{
+    return m_timestampsCount;
+}
+
+int SlidingWindowStats::recentKeystrokes() const
+{
+    return m_keystrokesCount;
+}
+
+int SlidingWindowStats::recentErrors() const
+{
+    return m_errors;
+}
+
+float SlidingWindowStats::accuracy() const
+{
+    if (m_keystrokesCount == 0)
+        return 1.0;
+
+    return 1.0 - float(m_errors) / float(m_keystrokesCount);
+}
@@ -0,0 +1,52 @@
+/*
+ *  Copyright 2026  The KTouch Developers <kde-edu@kde.org>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SLIDINGWINDOWSTATS_H
+#define SLIDINGWINDOWSTATS_H
+
+#include <QtGlobal>
+#include <QVector>
+
+/*
+ * Speed over the last few seconds and accuracy over the last few keystrokes,
+ * both kept in ring buffers so every keystroke costs constant time.
+ */
+class SlidingWindowStats
+{
+public:
+    SlidingWindowStats(qint64 windowNSecs, int windowKeystrokes);
+    qint64 windowNSecs() const;
+    int windowKeystrokes() const;
+    void add(qint64 timestamp, bool correct);
+    void expire(qint64 now);
+    void clear();
+    int recentCharacters() const;
+    int recentKeystrokes() const;
+    int recentErrors() const;
+    float accuracy() const;
+private:
+    qint64 m_windowNSecs;
+    QVector<qint64> m_timestamps;
+    int m_timestampsHead;
+    int m_timestampsCount;
+    QVector<bool> m_keystrokes;
+    int m_keystrokesHead;
+    int m_keystrokesCount;
+    int m_errors;
+};
+
+#endif // SLIDINGWINDOWSTATS_H
@@ -17,19 +17,42 @@
 
 #include "trainingstats.h"
 
-#include <QDateTime>
 #include <QTimer>
 
+#include <algorithm>
+
+#include "core/keyboardlayout.h"
+
+// pauses longer than this are breaks, not transitions between keys
+static const qint64 MaximumTransitionTime = Q_INT64_C(2000000000);
+
+// the live meters show the speed of the last 10 s and the accuracy of the last 50 keystrokes
+static const qint64 RecentSpeedWindow = Q_INT64_C(10000000000);
+static const int RecentAccuracyWindow = 50;
+
 TrainingStats::TrainingStats(QObject* parent) :
     QObject(parent),
     m_timeIsRunning(false),
+    m_liveUpdates(true),
     m_charactersTyped(0),
     m_elapsedTime(0),
     m_errorCount(0),
     m_isValid(true),
     m_startTime(0),
-    m_updateTimer(new QTimer(this))
+    m_clockLatched(false),
+    m_latchedTime(0),
+    m_sequenceStart(0),
+    m_bigramStats(2, 2048),
+    m_trigramStats(3, 4096),
+    m_recentStats(RecentSpeedWindow, RecentAccuracyWindow),
+    m_updateTimer(new QTimer(this)),
+    m_batchDepth(0),
+    m_keystrokesPending(false),
+    m_errorsPending(false)
 {
+    m_sessionClock.start();
+    m_updateTimer->setSingleShot(true);
+    m_updateTimer->setTimerType(Qt::PreciseTimer);
     connect(m_updateTimer, &QTimer::timeout, this, &TrainingStats::update);
 }
 
@@ -49,25 +72,21 @@ void TrainingStats::setCharactersTyped(int charactesTyped)
 
 QTime TrainingStats::elapsedTime() const
 {
-    return QTime(0, 0).addMSecs(m_elapsedTime);
+    return QTime(0, 0).addMSecs(elapsedMSecs());
 }
 
 void TrainingStats::setElapsedTime(const QTime& elapsedTime)
 {
-    quint64 msec = elapsedTime.msec();
-
-    if(msec != m_elapsedTime)
-    {
-        m_elapsedTime = msec;
-        emit statsChanged();
-    }
+    setElapsedTime(quint64(elapsedTime.msec()));
 }
 
 void TrainingStats::setElapsedTime(const quint64& msec)
 {
-    if(msec != m_elapsedTime)
+    if(msec != elapsedMSecs())
     {
         m_elapsedTime = msec;
+        m_startTime = clockNSecs() / 1000000 - qint64(msec);
+        scheduleUpdate();
         emit statsChanged();
     }
 }
@@ -101,12 +120,23 @@ void TrainingStats::setIsValid(bool isValid)
 }
 QMap< QString, int > TrainingStats::errorMap() const
 {
-    return m_errorMap;
+    return m_confusionMatrix.toErrorMap();
 }
 
 void TrainingStats::setErrorMap(const QMap< QString, int >& errorMap)
 {
-    m_errorMap = errorMap;
+    m_confusionMatrix = ConfusionMatrix::fromErrorMap(errorMap);
+    emit errorsChanged();
+}
+
+const ConfusionMatrix& TrainingStats::confusionMatrix() const
+{
+    return m_confusionMatrix;
+}
+
+void TrainingStats::setConfusionMatrix(const ConfusionMatrix& confusionMatrix)
+{
+    m_confusionMatrix = confusionMatrix;
     emit errorsChanged();
 }
 
@@ -115,12 +145,120 @@ bool TrainingStats::timeIsRunning() const
     return m_timeIsRunning;
 }
 
+bool TrainingStats::liveUpdates() const
+{
+    return m_liveUpdates;
+}
+
+void TrainingStats::setLiveUpdates(bool liveUpdates)
+{
+    if (liveUpdates != m_liveUpdates)
+    {
+        m_liveUpdates = liveUpdates;
+        emit liveUpdatesChanged();
+
+        if (m_liveUpdates)
+        {
+            update();
+        }
+        else
+        {
+            m_updateTimer->stop();
+        }
+    }
+}
+
+const KeystrokeTimeline& TrainingStats::keystrokeTimeline() const
+{
+    return m_keystrokeTimeline;
+}
+
+int TrainingStats::keystrokeCount() const
+{
+    return m_keystrokeTimeline.count();
+}
+
+QVariantMap TrainingStats::keystroke(int index) const
+{
+    QVariantMap result;
+
+    if (index < 0 || index >= m_keystrokeTimeline.count())
+        return result;
+
+    const Keystroke& entry = m_keystrokeTimeline.at(index);
+    result.insert(QStringLiteral("timestamp"), entry.timestamp);
+    result.insert(QStringLiteral("expected"), QString::fromUcs4(&entry.expected, 1));
+    result.insert(QStringLiteral("typed"), QString::fromUcs4(&entry.typed, 1));
+    result.insert(QStringLiteral("correct"), entry.correct);
+    return result;
+}
+
+const NGramStats& TrainingStats::bigramStats() const
+{
+    return m_bigramStats;
+}
+
+const NGramStats& TrainingStats::trigramStats() const
+{
+    return m_trigramStats;
+}
+
+QVariantList TrainingStats::slowestTransitions(int count) const
+{
+    QVector<NGramStats::Entry> entries = m_bigramStats.entries();
+
+    std::sort(entries.begin(), entries.end(), [](const NGramStats::Entry& left, const NGramStats::Entry& right) {
+        return left.mean > right.mean;
+    });
+
+    QVariantList result;
+
+    for (int i = 0; i < qMin(count, entries.count()); i++)
+    {
+        const NGramStats::Entry& entry = entries.at(i);
+        QVariantMap transition;
+        transition.insert(QStringLiteral("ngram"), m_bigramStats.ngram(entry));
+        transition.insert(QStringLiteral("count"), entry.count);
+        transition.insert(QStringLiteral("mean"), entry.mean);
+        transition.insert(QStringLiteral("variance"), entry.variance());
+        result.append(transition);
+    }
+
+    return result;
+}
+
+KeyboardLayout* TrainingStats::keyboardLayout() const
+{
+    return m_keyboardLayout;
+}
+
+void TrainingStats::setKeyboardLayout(KeyboardLayout* keyboardLayout)
+{
+    if (keyboardLayout != m_keyboardLayout)
+    {
+        m_keyboardLayout = keyboardLayout;
+        m_fingerStats.setKeyboardLayout(keyboardLayout);
+        emit keyboardLayoutChanged();
+    }
+}
+
+const FingerStats& TrainingStats::fingerStats() const
+{
+    return m_fingerStats;
+}
+
 void TrainingStats::startTraining()
 {
     if (!m_timeIsRunning)
     {
+        const bool latched = latchClock();
         m_timeIsRunning = true;
-        m_startTime = QDateTime::currentMSecsSinceEpoch() - m_elapsedTime;
+        m_startTime = clockNSecs() / 1000000 - qint64(m_elapsedTime);
+        emit trainingStarted();
+
+        if (latched)
+            releaseClock();
+
         update();
     }
 }
@@ -129,7 +267,15 @@ void TrainingStats::stopTraining()
 {
     if (m_timeIsRunning)
     {
+        const bool latched = latchClock();
+        m_elapsedTime = elapsedMSecs();
         m_timeIsRunning = false;
+        m_sequenceStart = m_keystrokeTimeline.count();
+        emit trainingStopped();
+
+        if (latched)
+            releaseClock();
+
         update();
     }
 }
@@ -140,12 +286,49 @@ void TrainingStats::reset()
     m_charactersTyped = 0;
     m_elapsedTime = 0;
     m_errorCount = 0;
-    m_errorMap.clear();
+    m_confusionMatrix.clear();
+    m_keystrokeTimeline.clear();
+    m_sequenceStart = 0;
+    m_bigramStats.clear();
+    m_trigramStats.clear();
+    m_recentStats.clear();
+    m_fingerStats.clear();
+    // the layout might have been loaded since it was set
+    m_fingerStats.setKeyboardLayout(m_keyboardLayout);
+    m_sessionClock.restart();
+    m_latchedTime = 0;
+    emit sessionReset();
+    emit keystrokesChanged();
     statsChanged();
 }
 
 void TrainingStats::logCharacter(const QString &character, EventType type)
 {
+    const uint expected = ConfusionMatrix::codePoint(character);
+    logCharacter(expected, type == TrainingStats::CorrectCharacter? expected: 0, type);
+}
+
+void TrainingStats::logCharacter(uint expected, uint typed, EventType type)
+{
+    const qint64 timestamp = clockNSecs();
+    qint64 interval = -1;
+
+    // like transitions, finger intervals only follow correct keystrokes without a break
+    if (m_keystrokeTimeline.count() > m_sequenceStart && m_keystrokeTimeline.last().correct)
+    {
+        interval = timestamp - m_keystrokeTimeline.last().timestamp;
+
+        if (interval > MaximumTransitionTime)
+        {
+            interval = -1;
+        }
+    }
+
+    m_keystrokeTimeline.append(timestamp, expected, typed, type == TrainingStats::CorrectCharacter);
+    m_fingerStats.add(expected, type == TrainingStats::CorrectCharacter, interval);
+    m_recentStats.add(timestamp, type == TrainingStats::CorrectCharacter);
+    logTransitions();
+
     if (type == TrainingStats::CorrectCharacter)
     {
         m_charactersTyped++;
@@ -153,17 +336,10 @@ void TrainingStats::logCharacter(const QString &character, EventType type)
     else
     {
         m_errorCount++;
-        if (m_errorMap.contains(character))
-        {
-            m_errorMap[character]++;
-        }
-        else
-        {
-            m_errorMap[character] = 1;
-        }
-
-        emit errorsChanged();
+        m_confusionMatrix.add(expected, typed);
     }
+
+    notifyChanges(true, type != TrainingStats::CorrectCharacter);
 }
 
 float TrainingStats::accuracy()
@@ -178,22 +354,166 @@ float TrainingStats::accuracy()
 
 int TrainingStats::charactersPerMinute()
 {
-    if (m_elapsedTime == 0)
+    const quint64 elapsedTime = elapsedMSecs();
+
+    if (elapsedTime == 0)
     {
         return 0;
     }
 
-    return m_charactersTyped * 60000 / m_elapsedTime;
+    return m_charactersTyped * 60000 / elapsedTime;
 }
 
-void TrainingStats::update()
+float TrainingStats::recentAccuracy() const
+{
+    return m_recentStats.accuracy();
+}
+
+int TrainingStats::recentCharactersPerMinute() const
+{
+    // at the start of a session the window isn't filled yet
+    const qint64 span = qMin(RecentSpeedWindow / 1000000, qint64(elapsedMSecs()));
+
+    if (span <= 0)
+    {
+        return 0;
+    }
+
+    return int(m_recentStats.recentCharacters() * Q_INT64_C(60000) / span);
+}
+
+void TrainingStats::logTransitions()
+{
+    const int last = m_keystrokeTimeline.count() - 1;
+
+    if (last - 1 < m_sequenceStart)
+        return;
+
+    const Keystroke& current = m_keystrokeTimeline.at(last);
+    const Keystroke& previous = m_keystrokeTimeline.at(last - 1);
+
+    if (!current.correct || !previous.correct)
+        return;
+
+    const qint64 interval = current.timestamp - previous.timestamp;
+
+    if (interval > MaximumTransitionTime)
+    {
+        m_sequenceStart = last;
+        return;
+    }
+
+    const uint bigram[2] = {previous.expected, current.expected};
+    m_bigramStats.add(bigram, interval / 1000000.0);
+
+    if (last - 2 < m_sequenceStart)
+        return;
+
+    const Keystroke& first = m_keystrokeTimeline.at(last - 2);
+
+    if (!first.correct || previous.timestamp - first.timestamp > MaximumTransitionTime)
+        return;
+
+    const uint trigram[3] = {first.expected, previous.expected, current.expected};
+    m_trigramStats.add(trigram, (current.timestamp - first.timestamp) / 1000000.0);
+}
+
+quint64 TrainingStats::elapsedMSecs() const
 {
-    m_updateTimer->stop();
     if (m_timeIsRunning)
     {
-        qint64 now = QDateTime::currentMSecsSinceEpoch();
-        m_elapsedTime = now - m_startTime;
-        m_updateTimer->start(200);
+        return quint64(qMax(Q_INT64_C(0), clockNSecs() / 1000000 - m_startTime));
+    }
+
+    return m_elapsedTime;
+}
+
+qint64 TrainingStats::clockNSecs() const
+{
+    return m_clockLatched? m_latchedTime: m_sessionClock.nsecsElapsed();
+}
+
+bool TrainingStats::latchClock()
+{
+    if (m_clockLatched)
+        return false;
+
+    // everything logged while the clock is latched shares one timestamp, in
+    // whole microseconds so that session recordings can reproduce it exactly
+    latchClockAt(m_sessionClock.nsecsElapsed() / 1000 * 1000);
+    return true;
+}
+
+void TrainingStats::latchClockAt(qint64 nsecs)
+{
+    m_latchedTime = nsecs;
+    m_clockLatched = true;
+}
+
+void TrainingStats::releaseClock()
+{
+    m_clockLatched = false;
+}
+
+void TrainingStats::beginBatch()
+{
+    m_batchDepth++;
+}
+
+void TrainingStats::endBatch()
+{
+    Q_ASSERT(m_batchDepth > 0);
+
+    if (--m_batchDepth > 0)
+        return;
+
+    const bool keystrokes = m_keystrokesPending;
+    const bool errors = m_errorsPending;
+
+    m_keystrokesPending = false;
+    m_errorsPending = false;
+
+    if (keystrokes || errors)
+    {
+        notifyChanges(keystrokes, errors);
     }
+}
+
+void TrainingStats::notifyChanges(bool keystrokes, bool errors)
+{
+    // during a batch the bindings are updated once when it ends, not for every keystroke
+    if (m_batchDepth > 0)
+    {
+        m_keystrokesPending = m_keystrokesPending || keystrokes;
+        m_errorsPending = m_errorsPending || errors;
+        return;
+    }
+
+    if (keystrokes)
+        emit keystrokesChanged();
+
+    if (errors)
+        emit errorsChanged();
+
+    emit statsChanged();
+}
+
+void TrainingStats::update()
+{
+    // let the speed of the last seconds decay while nothing is typed
+    m_recentStats.expire(clockNSecs());
+    scheduleUpdate();
     emit statsChanged();
 }
+
+void TrainingStats::scheduleUpdate()
+{
+    if (!m_timeIsRunning || !m_liveUpdates)
+    {
+        m_updateTimer->stop();
+        return;
+    }
+
+    // wake up once the displayed elapsed time changes to the next second
+    m_updateTimer->start(1000 - int(elapsedMSecs() % 1000));
+}
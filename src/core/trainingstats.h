@@ -20,11 +20,22 @@
 
 #include <QObject>
 #include <QChar>
+#include <QElapsedTimer>
 #include <QTime>
 #include <QMap>
+#include <QPointer>
 #include <QString>
+#include <QVariantList>
+#include <QVariantMap>
+
+#include "core/confusionmatrix.h"
+#include "core/fingerstats.h"
+#include "core/keystroketimeline.h"
+#include "core/ngramstats.h"
+#include "core/slidingwindowstats.h"
 
 class QTimer;
+class KeyboardLayout;
 
 class TrainingStats : public QObject
 {
@@ -36,7 +47,12 @@ class TrainingStats : public QObject
     Q_PROPERTY(bool isValid READ isValid WRITE setIsValid NOTIFY isValidChanged)
     Q_PROPERTY(float accuracy READ accuracy NOTIFY statsChanged)
     Q_PROPERTY(int charactersPerMinute READ charactersPerMinute NOTIFY statsChanged)
+    Q_PROPERTY(float recentAccuracy READ recentAccuracy NOTIFY statsChanged)
+    Q_PROPERTY(int recentCharactersPerMinute READ recentCharactersPerMinute NOTIFY statsChanged)
     Q_PROPERTY(bool timeIsRunning READ timeIsRunning NOTIFY statsChanged)
+    Q_PROPERTY(bool liveUpdates READ liveUpdates WRITE setLiveUpdates NOTIFY liveUpdatesChanged)
+    Q_PROPERTY(int keystrokeCount READ keystrokeCount NOTIFY keystrokesChanged)
+    Q_PROPERTY(KeyboardLayout* keyboardLayout READ keyboardLayout WRITE setKeyboardLayout NOTIFY keyboardLayoutChanged)
 
 public:
     enum EventType {
@@ -56,29 +72,75 @@ public:
     void setIsValid(bool isValid);
     QMap<QString, int> errorMap() const;
     void setErrorMap(const QMap<QString, int>& errorMap);
+    const ConfusionMatrix& confusionMatrix() const;
+    void setConfusionMatrix(const ConfusionMatrix& confusionMatrix);
     bool timeIsRunning() const;
+    bool liveUpdates() const;
+    void setLiveUpdates(bool liveUpdates);
+    const KeystrokeTimeline& keystrokeTimeline() const;
+    int keystrokeCount() const;
+    Q_INVOKABLE QVariantMap keystroke(int index) const;
+    const NGramStats& bigramStats() const;
+    const NGramStats& trigramStats() const;
+    Q_INVOKABLE QVariantList slowestTransitions(int count) const;
+    KeyboardLayout* keyboardLayout() const;
+    void setKeyboardLayout(KeyboardLayout* keyboardLayout);
+    const FingerStats& fingerStats() const;
     Q_INVOKABLE void startTraining();
     Q_INVOKABLE void stopTraining();
     Q_INVOKABLE void reset();
     Q_INVOKABLE void logCharacter(const QString &character, EventType type);
+    void logCharacter(uint expected, uint typed, EventType type);
     float accuracy();
     int charactersPerMinute();
+    float recentAccuracy() const;
+    int recentCharactersPerMinute() const;
+    quint64 elapsedMSecs() const;
+    qint64 clockNSecs() const;
+    bool latchClock();
+    void latchClockAt(qint64 nsecs);
+    void releaseClock();
+    void beginBatch();
+    void endBatch();
 
 signals:
     void statsChanged();
     void isValidChanged();
+    void liveUpdatesChanged();
     void errorsChanged();
+    void keystrokesChanged();
+    void keyboardLayoutChanged();
+    void trainingStarted();
+    void trainingStopped();
+    void sessionReset();
 
 private:
     Q_SLOT void update();
+    void scheduleUpdate();
+    void notifyChanges(bool keystrokes, bool errors);
+    void logTransitions();
     bool m_timeIsRunning;
+    bool m_liveUpdates;
     int m_charactersTyped;
     quint64 m_elapsedTime;
     int m_errorCount;
     bool m_isValid;
-    QMap<QString, int> m_errorMap;
-    quint64 m_startTime;
+    ConfusionMatrix m_confusionMatrix;
+    qint64 m_startTime;
+    QElapsedTimer m_sessionClock;
+    bool m_clockLatched;
+    qint64 m_latchedTime;
+    KeystrokeTimeline m_keystrokeTimeline;
+    int m_sequenceStart;
+    NGramStats m_bigramStats;
+    NGramStats m_trigramStats;
+    SlidingWindowStats m_recentStats;
+    QPointer<KeyboardLayout> m_keyboardLayout;
+    FingerStats m_fingerStats;
     QTimer* m_updateTimer;
+    int m_batchDepth;
+    bool m_keystrokesPending;
+    bool m_errorsPending;
 };
 
 #endif // TRAININGSTATS_H
@@ -420,6 +420,7 @@ bool UserDataAccess::loadKeyboardLayout(const QString& id, KeyboardLayout* targe
         target->addKey(abstractKey);
     }
 
+    target->prepareKeyLookup();
     target->setIsValid(true);
 
     return true;
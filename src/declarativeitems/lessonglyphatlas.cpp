@@ -0,0 +1,210 @@
+/*
+ *  Copyright 2026  The KTouch Developers <kde-edu@kde.org>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "lessonglyphatlas.h"
+
+#include <QGlyphRun>
+#include <QPainter>
+
+static const int AtlasWidth = 512;
+static const int MinimumAtlasHeight = 64;
+static const int MaximumAtlasHeight = 4096;
+
+LessonGlyphAtlas::LessonGlyphAtlas() :
+    m_rowX(0),
+    m_rowY(0),
+    m_rowHeight(0),
+    m_overflowed(false),
+    m_revision(0),
+    m_scale(0),
+    m_devicePixelRatio(0)
+{
+    clear();
+}
+
+bool LessonGlyphAtlas::setScale(qreal scale, qreal devicePixelRatio)
+{
+    if (scale == m_scale && devicePixelRatio == m_devicePixelRatio)
+        return false;
+
+    // glyphs are rasterized at their final size
+    clear();
+    m_scale = scale;
+    m_devicePixelRatio = devicePixelRatio;
+    return true;
+}
+
+qreal LessonGlyphAtlas::scale() const
+{
+    return m_scale;
+}
+
+qreal LessonGlyphAtlas::devicePixelRatio() const
+{
+    return m_devicePixelRatio;
+}
+
+void LessonGlyphAtlas::clear()
+{
+    m_glyphStyles.clear();
+    m_glyphs.clear();
+    m_image = QImage(AtlasWidth, MinimumAtlasHeight, QImage::Format_ARGB32_Premultiplied);
+    m_image.fill(Qt::transparent);
+    m_rowX = 0;
+    m_rowY = 0;
+    m_rowHeight = 0;
+    m_overflowed = false;
+    m_revision++;
+}
+
+bool LessonGlyphAtlas::hasOverflowed() const
+{
+    return m_overflowed;
+}
+
+int LessonGlyphAtlas::revision() const
+{
+    return m_revision;
+}
+
+const QImage& LessonGlyphAtlas::image() const
+{
+    return m_image;
+}
+
+int LessonGlyphAtlas::glyphStyle(const QRawFont& font, const QColor& color)
+{
+    // a lesson uses a handful of fonts and colors, they are looked up once per glyph run
+    for (int i = 0; i < m_glyphStyles.count(); i++)
+    {
+        const GlyphStyle& style = m_glyphStyles.at(i);
+
+        if (style.color == color.rgba() &&
+                style.pixelSize == font.pixelSize() &&
+                style.weight == font.weight() &&
+                style.style == font.style() &&
+                style.familyName == font.familyName() &&
+                style.styleName == font.styleName())
+        {
+            return i;
+        }
+    }
+
+    GlyphStyle style;
+    style.familyName = font.familyName();
+    style.styleName = font.styleName();
+    style.pixelSize = font.pixelSize();
+    style.weight = font.weight();
+    style.style = font.style();
+    style.color = color.rgba();
+    style.scaledFont = font;
+    style.scaledFont.setPixelSize(font.pixelSize() * m_scale * m_devicePixelRatio);
+    m_glyphStyles.append(style);
+
+    return m_glyphStyles.count() - 1;
+}
+
+const LessonGlyphAtlas::Glyph& LessonGlyphAtlas::glyph(int style, quint32 glyphIndex)
+{
+    const quint64 key = (quint64(style) << 32) | glyphIndex;
+    QHash<quint64, Glyph>::const_iterator it = m_glyphs.constFind(key);
+
+    if (it != m_glyphs.constEnd())
+        return it.value();
+
+    const QRawFont& scaledFont = m_glyphStyles.at(style).scaledFont;
+    const QRectF bounds = scaledFont.boundingRect(glyphIndex);
+
+    Glyph glyph;
+
+    // whitespace has nothing to draw, but is cached as well
+    if (!bounds.isEmpty())
+    {
+        const QRect pixelBounds = bounds.toAlignedRect().adjusted(-1, -1, 1, 1);
+        QPoint position;
+
+        if (allocate(pixelBounds.size(), &position))
+        {
+            QGlyphRun glyphRun;
+            glyphRun.setRawFont(scaledFont);
+            glyphRun.setGlyphIndexes(QVector<quint32>() << glyphIndex);
+            glyphRun.setPositions(QVector<QPointF>() << QPointF(position - pixelBounds.topLeft()));
+
+            QPainter painter(&m_image);
+            painter.setPen(QColor::fromRgba(m_glyphStyles.at(style).color));
+            painter.drawGlyphRun(QPointF(0, 0), glyphRun);
+            painter.end();
+
+            glyph.rect = QRect(position, pixelBounds.size());
+            glyph.offset = pixelBounds.topLeft();
+            m_revision++;
+        }
+    }
+
+    return m_glyphs.insert(key, glyph).value();
+}
+
+bool LessonGlyphAtlas::allocate(const QSize& size, QPoint* position)
+{
+    if (size.width() > AtlasWidth)
+    {
+        m_overflowed = true;
+        return false;
+    }
+
+    // glyphs are put next to each other in rows as high as their tallest glyph
+    if (m_rowX + size.width() > AtlasWidth)
+    {
+        m_rowX = 0;
+        m_rowY += m_rowHeight;
+        m_rowHeight = 0;
+    }
+
+    const int height = m_rowY + size.height();
+
+    if (height > MaximumAtlasHeight)
+    {
+        m_overflowed = true;
+        return false;
+    }
+
+    if (height > m_image.height())
+    {
+        int imageHeight = m_image.height();
+
+        while (imageHeight < height)
+        {
+            imageHeight *= 2;
+        }
+
+        // the rows already taken are kept, the new part of the image is left transparent
+        QImage image(AtlasWidth, imageHeight, QImage::Format_ARGB32_Premultiplied);
+        image.fill(Qt::transparent);
+
+        QPainter painter(&image);
+        painter.setCompositionMode(QPainter::CompositionMode_Source);
+        painter.drawImage(0, 0, m_image);
+        painter.end();
+
+        m_image = image;
+    }
+
+    *position = QPoint(m_rowX, m_rowY);
+    m_rowX += size.width();
+    m_rowHeight = qMax(m_rowHeight, size.height());
+    return true;
+}
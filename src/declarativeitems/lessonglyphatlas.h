@@ -0,0 +1,79 @@
+/*
+ *  Copyright 2026  The KTouch Developers <kde-edu@kde.org>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LESSONGLYPHATLAS_H
+#define LESSONGLYPHATLAS_H
+
+#include <QColor>
+#include <QFont>
+#include <QHash>
+#include <QImage>
+#include <QPoint>
+#include <QRawFont>
+#include <QRect>
+#include <QString>
+#include <QVector>
+
+// rasterized glyphs of the lesson packed into a single image in rows, the
+// scene graph uploads the image as one texture for all glyphs
+class LessonGlyphAtlas
+{
+public:
+    struct Glyph
+    {
+        // position in the atlas and offset from the glyph origin, in device pixels
+        QRect rect;
+        QPoint offset;
+    };
+
+    LessonGlyphAtlas();
+    bool setScale(qreal scale, qreal devicePixelRatio);
+    qreal scale() const;
+    qreal devicePixelRatio() const;
+    void clear();
+    bool hasOverflowed() const;
+    int revision() const;
+    const QImage& image() const;
+    int glyphStyle(const QRawFont& font, const QColor& color);
+    const Glyph& glyph(int style, quint32 glyphIndex);
+
+private:
+    struct GlyphStyle
+    {
+        QString familyName;
+        QString styleName;
+        qreal pixelSize;
+        int weight;
+        QFont::Style style;
+        QRgb color;
+        QRawFont scaledFont;
+    };
+
+    bool allocate(const QSize& size, QPoint* position);
+    QVector<GlyphStyle> m_glyphStyles;
+    QHash<quint64, Glyph> m_glyphs;
+    QImage m_image;
+    int m_rowX;
+    int m_rowY;
+    int m_rowHeight;
+    bool m_overflowed;
+    int m_revision;
+    qreal m_scale;
+    qreal m_devicePixelRatio;
+};
+
+#endif // LESSONGLYPHATLAS_H
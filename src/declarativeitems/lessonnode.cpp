@@ -0,0 +1,132 @@
+/*
+ *  Copyright 2026  The KTouch Developers <kde-edu@kde.org>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "lessonnode.h"
+
+#include <QSGTexture>
+
+#include <algorithm>
+
+LessonNode::LessonNode() :
+    QSGNode(),
+    m_atlasTexture(0),
+    m_atlasRevision(-1)
+{
+}
+
+LessonNode::~LessonNode()
+{
+    // the geometry nodes share the materials, they have to go first
+    setBlockCount(0);
+    delete m_atlasTexture;
+}
+
+int LessonNode::atlasRevision() const
+{
+    return m_atlasRevision;
+}
+
+bool LessonNode::setAtlas(QSGTexture* texture, int revision)
+{
+    const QSize oldSize = m_atlasTexture? m_atlasTexture->textureSize(): QSize();
+    const QSize newSize = texture->textureSize();
+
+    m_glyphMaterial.setTexture(texture);
+    delete m_atlasTexture;
+    m_atlasTexture = texture;
+    m_atlasRevision = revision;
+
+    foreach (QSGNode* blockNode, m_blockNodes)
+    {
+        blockNode->childAtIndex(1)->markDirty(QSGNode::DirtyMaterial);
+    }
+
+    // the texture coordinates of all blocks are relative to the size of the atlas
+    return newSize != oldSize;
+}
+
+int LessonNode::blockCount() const
+{
+    return m_blockNodes.count();
+}
+
+void LessonNode::setBlockCount(int blockCount)
+{
+    foreach (QSGNode* blockNode, m_blockNodes)
+    {
+        removeChildNode(blockNode);
+        delete blockNode;
+    }
+
+    m_blockNodes.clear();
+
+    // every block is drawn with three nodes: backgrounds, glyphs and underlines
+    for (int i = 0; i < blockCount; i++)
+    {
+        QSGNode* blockNode = new QSGNode();
+        blockNode->appendChildNode(createGeometryNode(QSGGeometry::defaultAttributes_ColoredPoint2D(), &m_colorMaterial));
+        blockNode->appendChildNode(createGeometryNode(QSGGeometry::defaultAttributes_TexturedPoint2D(), &m_glyphMaterial));
+        blockNode->appendChildNode(createGeometryNode(QSGGeometry::defaultAttributes_ColoredPoint2D(), &m_colorMaterial));
+        appendChildNode(blockNode);
+        m_blockNodes.append(blockNode);
+    }
+}
+
+void LessonNode::updateBlock(int index, const LessonBlockGeometry& geometry)
+{
+    QSGNode* blockNode = m_blockNodes.at(index);
+
+    setColoredVertices(static_cast<QSGGeometryNode*>(blockNode->childAtIndex(0)), geometry.backgrounds);
+    setColoredVertices(static_cast<QSGGeometryNode*>(blockNode->childAtIndex(2)), geometry.underlines);
+
+    QSGGeometryNode* glyphNode = static_cast<QSGGeometryNode*>(blockNode->childAtIndex(1));
+    QSGGeometry* glyphGeometry = glyphNode->geometry();
+    const QSize atlasSize = m_atlasTexture->textureSize();
+    const int vertexCount = geometry.glyphs.count();
+
+    glyphGeometry->allocate(vertexCount);
+    QSGGeometry::TexturedPoint2D* vertices = glyphGeometry->vertexDataAsTexturedPoint2D();
+
+    for (int i = 0; i < vertexCount; i++)
+    {
+        const QSGGeometry::TexturedPoint2D& vertex = geometry.glyphs.at(i);
+        vertices[i].set(vertex.x, vertex.y, vertex.tx / atlasSize.width(), vertex.ty / atlasSize.height());
+    }
+
+    glyphNode->markDirty(QSGNode::DirtyGeometry);
+}
+
+QSGGeometryNode* LessonNode::createGeometryNode(const QSGGeometry::AttributeSet& attributes, QSGMaterial* material)
+{
+    QSGGeometry* geometry = new QSGGeometry(attributes, 0);
+    geometry->setDrawingMode(QSGGeometry::DrawTriangles);
+
+    QSGGeometryNode* node = new QSGGeometryNode();
+    node->setGeometry(geometry);
+    node->setFlag(QSGNode::OwnsGeometry);
+    node->setMaterial(material);
+    return node;
+}
+
+void LessonNode::setColoredVertices(QSGGeometryNode* node, const QVector<QSGGeometry::ColoredPoint2D>& vertices)
+{
+    QSGGeometry* geometry = node->geometry();
+
+    geometry->allocate(vertices.count());
+    std::copy(vertices.constBegin(), vertices.constEnd(), geometry->vertexDataAsColoredPoint2D());
+    node->markDirty(QSGNode::DirtyGeometry);
+}
@@ -0,0 +1,61 @@
+/*
+ *  Copyright 2026  The KTouch Developers <kde-edu@kde.org>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LESSONNODE_H
+#define LESSONNODE_H
+
+#include <QSGGeometry>
+#include <QSGNode>
+#include <QSGTextureMaterial>
+#include <QSGVertexColorMaterial>
+#include <QPointF>
+#include <QVector>
+
+class QSGTexture;
+
+// the triangles of a text block, prepared on the GUI thread; the texture
+// coordinates of the glyphs are given in pixels of the glyph atlas
+struct LessonBlockGeometry
+{
+    QPointF position;
+    QVector<QSGGeometry::ColoredPoint2D> backgrounds;
+    QVector<QSGGeometry::TexturedPoint2D> glyphs;
+    QVector<QSGGeometry::ColoredPoint2D> underlines;
+};
+
+class LessonNode : public QSGNode
+{
+public:
+    LessonNode();
+    ~LessonNode();
+    int atlasRevision() const;
+    bool setAtlas(QSGTexture* texture, int revision);
+    int blockCount() const;
+    void setBlockCount(int blockCount);
+    void updateBlock(int index, const LessonBlockGeometry& geometry);
+
+private:
+    QSGGeometryNode* createGeometryNode(const QSGGeometry::AttributeSet& attributes, QSGMaterial* material);
+    void setColoredVertices(QSGGeometryNode* node, const QVector<QSGGeometry::ColoredPoint2D>& vertices);
+    QVector<QSGNode*> m_blockNodes;
+    QSGTexture* m_atlasTexture;
+    int m_atlasRevision;
+    QSGTextureMaterial m_glyphMaterial;
+    QSGVertexColorMaterial m_colorMaterial;
+};
+
+#endif // LESSONNODE_H
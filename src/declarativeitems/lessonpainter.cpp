@@ -19,18 +19,81 @@
 
 #include <qmath.h>
 #include <QAbstractTextDocumentLayout>
+#include <QFontMetricsF>
+#include <QHash>
+#include <QImage>
 #include <QPainter>
+#include <QQuickWindow>
 #include <QTextCharFormat>
 #include <QTextCursor>
 #include <QTextDocument>
 #include <QTextFrame>
+#include <QTimer>
 
+#include "bindings/latencymonitor.h"
 #include "core/lesson.h"
+#include "declarativeitems/lessontextengine.h"
 #include "declarativeitems/traininglinecore.h"
+#include "preferences.h"
+#include "replay/sessionrecorder.h"
+
+// lessons with more lines than this only have a window of their lines in the
+// document, laid out around the visible area and the current line
+static const int VirtualizationThreshold = 500;
+static const int InitialWindowLines = 200;
+static const int WindowMargin = 50;
+static const int MaximumWindowLines = 1000;
+
+static const qreal DocumentMargin = 20.0;
+
+// identifies the content a document has been built from
+struct LessonSource
+{
+    QString title;
+    QString text;
+    bool paragraphMode;
+    bool training;
+
+    LessonSource() :
+        paragraphMode(false),
+        training(false)
+    {
+    }
+
+    bool operator==(const LessonSource& other) const
+    {
+        return !text.isNull() && title == other.title && text == other.text &&
+                paragraphMode == other.paragraphMode && training == other.training;
+    }
+};
+
+// a finished line as it is shown, kept to restore it when the window moves
+struct CommittedLine
+{
+    QString text;
+    QByteArray formats;
+};
+
+// a rasterized text block, the unit the image cache is invalidated in
+struct LessonTile
+{
+    QImage image;
+    QRectF blockRect;
+    QPointF position;
+};
 
 struct LessonPainterPrivate
 {
-    LessonPainterPrivate()
+    enum DisplayedFormat {
+        PlaceHolderFormat,
+        TextFormat,
+        ErrorFormat,
+        PreeditFormat
+    };
+
+    LessonPainterPrivate() :
+        nextDocWrapWidth(-1),
+        nextDocWindowEnd(0)
     {
         blockFormat.setLineHeight(200, QTextBlockFormat::ProportionalHeight);
 
@@ -52,6 +115,8 @@ struct LessonPainterPrivate
         titleCharFormat = textCharFormat;
         titleCharFormat.setFontFamily(QStringLiteral("sans-serif"));
         titleCharFormat.setFontPointSize(15);
+
+        displayedCharFormats << placeHolderCharFormat << textCharFormat << errorCharFormat << preeditCharFromat;
     }
 
     QTextBlockFormat blockFormat;
@@ -61,21 +126,55 @@ struct LessonPainterPrivate
     QTextCharFormat errorCharFormat;
     QTextCharFormat preeditCharFromat;
     QTextCharFormat titleCharFormat;
+    QVector<QTextCharFormat> displayedCharFormats;
+
+    LessonSource docSource;
+    LessonSource nextDocSource;
+    QStringList nextDocLines;
+    qreal nextDocWrapWidth;
+    int nextDocWindowEnd;
+    QSizeF nextDocSize;
+
+    QHash<int, LessonTile> tiles;
+
+    // what the current training line shows, per position of the reference line;
+    // it is drawn from the text engine and only written to the document once done
+    QString displayedLine;
+    QByteArray displayedFormats;
+    LessonTextEngine textEngine;
+    QHash<int, CommittedLine> committedLines;
 };
 
 LessonPainter::LessonPainter(QQuickItem* parent) :
     QQuickPaintedItem(parent),
     d(new LessonPainterPrivate()),
     m_doc(new QTextDocument(this)),
+    m_nextDoc(new QTextDocument(this)),
     m_textScale(1.0),
+    m_paragraphMode(false),
+    m_wrapWidth(-1),
+    m_styledEnd(0),
+    m_windowStart(0),
+    m_windowEnd(0),
+    m_textTop(0),
+    m_windowOffset(0),
+    m_prefetchTimer(new QTimer(this)),
     m_maximumWidth(0),
     m_maximumHeight(-1),
-    m_imageCacheDirty(false),
+    m_contentHeight(0),
     m_trainingLineCore(0),
     m_currentLine(0)
 {
     this->setFlag(QQuickPaintedItem::ItemHasContents, true);
     m_doc->setUseDesignMetrics(true);
+    m_nextDoc->setUseDesignMetrics(true);
+    m_doc->setUndoRedoEnabled(false);
+    m_nextDoc->setUndoRedoEnabled(false);
+
+    // prepare what comes next once the current event has been handled
+    m_prefetchTimer->setSingleShot(true);
+    m_prefetchTimer->setInterval(0);
+    connect(m_prefetchTimer, &QTimer::timeout, this, &LessonPainter::prefetch);
 }
 
 LessonPainter::~LessonPainter()
@@ -111,6 +210,21 @@ void LessonPainter::setLesson(Lesson* lesson)
     }
 }
 
+Lesson* LessonPainter::nextLesson() const
+{
+    return m_nextLesson;
+}
+
+void LessonPainter::setNextLesson(Lesson* nextLesson)
+{
+    if (nextLesson != m_nextLesson)
+    {
+        m_nextLesson = nextLesson;
+        m_prefetchTimer->start();
+        emit nextLessonChanged();
+    }
+}
+
 qreal LessonPainter::maximumWidth() const
 {
     return m_maximumWidth;
@@ -160,7 +274,7 @@ void LessonPainter::setTrainingLineCore(TrainingLineCore* trainingLineCore)
 
         if (m_trainingLineCore)
         {
-            connect(m_trainingLineCore, &TrainingLineCore::actualLineChanged, this, &LessonPainter::updateTrainingStatus);
+            connect(m_trainingLineCore, &TrainingLineCore::actualLineSpanChanged, this, &LessonPainter::updateTrainingStatusSpan);
             connect(m_trainingLineCore, &TrainingLineCore::preeditStringChanged, this, &LessonPainter::updateTrainingStatus);
             connect(m_trainingLineCore, &TrainingLineCore::done, this, &LessonPainter::advanceToNextTrainingLine);
         }
@@ -172,29 +286,212 @@ QRectF LessonPainter::cursorRectangle() const
     return m_cursorRectangle;
 }
 
+QRectF LessonPainter::visibleArea() const
+{
+    return m_visibleArea;
+}
+
+void LessonPainter::setVisibleArea(const QRectF& visibleArea)
+{
+    if (visibleArea != m_visibleArea)
+    {
+        m_visibleArea = visibleArea;
+        updateWindow();
+        updatePaintedArea();
+        dropDistantTiles();
+        emit visibleAreaChanged();
+    }
+}
+
+qreal LessonPainter::contentHeight() const
+{
+    return m_contentHeight;
+}
+
+int LessonPainter::currentLine() const
+{
+    return m_currentLine;
+}
+
+qreal LessonPainter::textScale() const
+{
+    return m_textScale;
+}
+
+int LessonPainter::blockCount() const
+{
+    return m_lesson? m_doc->blockCount(): 0;
+}
+
+QPointF LessonPainter::blockPosition(int blockNumber) const
+{
+    return blockRect(m_doc->findBlockByNumber(blockNumber)).topLeft();
+}
+
+LessonGlyphs LessonPainter::blockGlyphs(int blockNumber) const
+{
+    return blockGlyphs(m_doc->findBlockByNumber(blockNumber));
+}
+
+QStringList LessonPainter::trainingUnits(const QString& text, bool paragraphs)
+{
+    const QStringList lines = text.split('\n');
+
+    if (!paragraphs)
+        return lines;
+
+    // in paragraph mode the lines between blank lines are trained as one unit
+    QStringList units;
+    QString unit;
+
+    foreach (const QString& line, lines)
+    {
+        if (line.trimmed().isEmpty())
+        {
+            if (!unit.isEmpty())
+            {
+                units.append(unit);
+                unit.clear();
+            }
+
+            continue;
+        }
+
+        if (!unit.isEmpty() && !unit.endsWith(QLatin1Char(' ')))
+        {
+            unit += QLatin1Char(' ');
+        }
+
+        unit += line;
+    }
+
+    if (!unit.isEmpty())
+    {
+        units.append(unit);
+    }
+
+    return units;
+}
+
 void LessonPainter::reset()
 {
-    m_lines = m_lesson? m_lesson->text().split('\n'): QStringList();
-    updateDoc();
+    m_paragraphMode = Preferences::paragraphTraining();
+
+    LessonSource source;
+
+    if (m_lesson)
+    {
+        source.title = m_lesson->title();
+        source.text = m_lesson->text();
+        source.paragraphMode = m_paragraphMode;
+        source.training = m_trainingLineCore != 0;
+    }
+
+    if (source == d->docSource)
+    {
+        // the same lesson is trained again, only the typed lines have to be restored
+        clearTrainingStatus();
+    }
+    else if (source == d->nextDocSource)
+    {
+        qSwap(m_doc, m_nextDoc);
+        d->textEngine.clear();
+        d->committedLines.clear();
+        d->docSource = source;
+        d->nextDocSource = LessonSource();
+        m_lines = d->nextDocLines;
+        m_wrapWidth = d->nextDocWrapWidth;
+        m_docSize = d->nextDocSize;
+        m_windowStart = 0;
+        m_windowEnd = d->nextDocWindowEnd;
+        estimateLineHeights();
+        updateLineGeometry();
+        updateLayout();
+    }
+    else
+    {
+        d->docSource = source;
+        m_lines = m_lesson? trainingUnits(source.text, m_paragraphMode): QStringList();
+        m_windowStart = 0;
+        m_windowEnd = initialWindowEnd(m_lines.length());
+        updateDoc();
+    }
+
     resetTrainingStatus();
+    m_prefetchTimer->start();
 }
 
 void LessonPainter::paint(QPainter* painter)
 {
-    if (m_imageCacheDirty)
+    if (!m_lesson || width() <= 0 || height() <= 0)
+        return;
+
+    // the item only covers the visible part of the lesson, everything is drawn in lesson coordinates
+    const qreal ratio = qFloor(painter->device()->width()) / width();
+    const QRectF paintArea = (painter->hasClipping()? painter->clipBoundingRect(): boundingRect()).translated(0, y());
+    painter->translate(0, -y());
+
+    for (QTextBlock block = m_doc->begin(); block.isValid(); block = block.next())
     {
-        const auto device = painter->device();
-        QImage img(QSize(qFloor(device->width()), qFloor(device->height())), QImage::Format_ARGB32_Premultiplied);
-        img.setDevicePixelRatio(img.width() / width());
-        img.fill(Qt::transparent);
-        QPainter painter(&img);
-        painter.scale(m_textScale, m_textScale);
-        m_doc->drawContents(&painter);
-        m_imageCache = img;
-        m_imageCacheDirty = false;
+        const QRectF blockRect = this->blockRect(block);
+        const QRectF itemRect(blockRect.topLeft() * m_textScale, blockRect.size() * m_textScale);
+
+        if (!itemRect.intersects(paintArea))
+            continue;
+
+        LessonTile& tile = d->tiles[block.blockNumber()];
+
+        if (tile.image.isNull() || tile.blockRect != blockRect || tile.image.devicePixelRatio() != ratio)
+        {
+            const QRect pixelRect = QRectF(itemRect.topLeft() * ratio, itemRect.size() * ratio).toAlignedRect();
+            QImage image(pixelRect.size(), QImage::Format_ARGB32_Premultiplied);
+            image.fill(Qt::transparent);
+            QPainter tilePainter(&image);
+            tilePainter.translate(-pixelRect.topLeft());
+            tilePainter.scale(m_textScale * ratio, m_textScale * ratio);
+
+            if (isTrainingBlock(block))
+            {
+                tilePainter.translate(blockRect.topLeft());
+                blockGlyphs(block).paint(&tilePainter);
+            }
+            else
+            {
+                // the document only holds the window, draw it shifted to where the block is shown
+                const QRectF docRect = m_doc->documentLayout()->blockBoundingRect(block);
+                tilePainter.translate(blockRect.topLeft() - docRect.topLeft());
+                m_doc->drawContents(&tilePainter, docRect);
+            }
+
+            tilePainter.end();
+            image.setDevicePixelRatio(ratio);
+
+            tile.image = image;
+            tile.blockRect = blockRect;
+            tile.position = QPointF(pixelRect.topLeft()) / ratio;
+        }
+
+        painter->drawImage(tile.position, tile.image);
+    }
+
+    LatencyMonitor::self()->markPaint();
+}
+
+void LessonPainter::itemChange(ItemChange change, const ItemChangeData& value)
+{
+    QQuickPaintedItem::itemChange(change, value);
+
+    if (change == ItemSceneChange)
+    {
+        LatencyMonitor::self()->attachWindow(value.window);
     }
 
-    painter->drawImage(0, 0, m_imageCache);
+    // a hidden painter keeps no pixels at all
+    if (change == ItemVisibleHasChanged)
+    {
+        d->tiles.clear();
+        updatePaintedArea();
+    }
 }
 
 void LessonPainter::updateLayout()
@@ -204,25 +501,20 @@ void LessonPainter::updateLayout()
     if (!m_lesson)
     {
         setWidth(0);
-        setHeight(0);
+        setContentHeight(0);
         return;
     }
 
-    // ### reset text width from previous run
-    m_doc->setTextWidth(-1);
-
-    const qreal docWidth = m_doc->idealWidth();
-    const qreal docHeight = m_doc->size().height();
+    // the document itself is laid out when it is built, only the scale depends on the available space
+    const qreal docWidth = m_docSize.width();
+    const qreal docHeight = m_docSize.height();
 
     m_textScale = m_maximumHeight != -1?
                 qMin(m_maximumWidth / docWidth, m_maximumHeight / docHeight):
                 m_maximumWidth / docWidth;
 
-    // ### without this text alignment won't work
-    m_doc->setTextWidth(docWidth);
-
     setWidth(qCeil(docWidth * m_textScale));
-    setHeight(qCeil(docHeight * m_textScale));
+    setContentHeight(qCeil(docHeight * m_textScale));
 
     updateCursorRectangle();
 }
@@ -232,58 +524,125 @@ void LessonPainter::resetTrainingStatus()
     if (!m_trainingLineCore || m_lines.length() == 0)
         return;
 
-    m_trainingLineCore->reset();
     m_currentLine = 0;
+    m_styledEnd = 0;
+    updateWindow();
+    resetDisplayedLine();
+    m_trainingLineCore->reset();
     m_trainingLineCore->setReferenceLine(m_lines[0]);
+    SessionRecorder::self()->recordLesson(m_lesson);
+    SessionRecorder::self()->recordLine(0);
 }
 
 void LessonPainter::updateTrainingStatus()
 {
-    if (m_currentLine >= m_lines.length())
+    if (!m_trainingLineCore)
         return;
 
-    QTextCursor cursor(m_doc);
+    updateTrainingStatusSpan(0, m_trainingLineCore->referenceLine().length());
+}
+
+void LessonPainter::updateTrainingStatusSpan(int start, int end)
+{
+    if (m_currentLine >= m_lines.length())
+        return;
 
     const QString referenceLine = m_trainingLineCore->referenceLine();
     const QString actualLine = m_trainingLineCore->actualLine();
     const QString preeditString = m_trainingLineCore->preeditString();
-    const QTextBlock block = m_doc->findBlockByNumber(m_currentLine + 1);
-    const int blockPosition = block.position();
 
-    for (int linePos = 0; linePos < referenceLine.length(); linePos++)
+    // the preedit string is shown after the end of the actual line and moves
+    // along with it; beyond what has been styled before the line still shows
+    // the placeholder text it was built with
+    const int styledEnd = actualLine.length() + preeditString.length();
+    end = qMin(qMax(end, styledEnd), qMax(m_styledEnd, styledEnd));
+    m_styledEnd = end >= m_styledEnd? styledEnd: qMax(m_styledEnd, styledEnd);
+
+    // grapheme clusters are always restyled as a whole so combining marks and
+    // surrogate pairs are never split across differently formatted fragments
+    start = m_trainingLineCore->graphemeClusterStart(qMax(0, start));
+    end = qMin(end, referenceLine.length());
+
+    // the document isn't touched while typing, only the displayed state of the
+    // clusters whose text or format differ from what is shown is updated
+    bool changed = false;
+    int clusterStart = start;
+
+    while (clusterStart < end)
     {
-        const bool typed = linePos < actualLine.length();
-        const bool preedit = !typed &&  linePos - actualLine.length() < preeditString.length();
-        const bool correct = typed && actualLine.at(linePos) == referenceLine.at(linePos);
+        const int clusterEnd = qMax(clusterStart + 1, m_trainingLineCore->graphemeClusterEnd(clusterStart));
+        QString displayedText;
+        bool typed = false;
+        bool preedit = false;
+        bool correct = true;
 
-        const QTextCharFormat charFormat = typed?
-                    (correct? d->textCharFormat: d->errorCharFormat):
-                    (preedit? d->preeditCharFromat: d->placeHolderCharFormat);
+        for (int linePos = clusterStart; linePos < clusterEnd; linePos++)
+        {
+            const bool charTyped = linePos < actualLine.length();
+            const bool charPreedit = !charTyped &&  linePos - actualLine.length() < preeditString.length();
+
+            if (linePos == clusterStart)
+            {
+                typed = charTyped;
+                preedit = charPreedit;
+            }
+
+            if (charTyped && actualLine.at(linePos) != referenceLine.at(linePos))
+            {
+                correct = false;
+            }
+
+            displayedText += charTyped?
+                        actualLine.at(linePos):
+                        charPreedit? preeditString.at(linePos - actualLine.length()): referenceLine.at(linePos);
+        }
 
-        const QChar displayedChar = typed?
-                    actualLine.at(linePos):
-                    preedit? preeditString.at(linePos - actualLine.length()): referenceLine.at(linePos);
+        const int format = typed?
+                    (correct? LessonPainterPrivate::TextFormat: LessonPainterPrivate::ErrorFormat):
+                    (preedit? LessonPainterPrivate::PreeditFormat: LessonPainterPrivate::PlaceHolderFormat);
+        bool clusterChanged = d->displayedLine.midRef(clusterStart, clusterEnd - clusterStart) != displayedText;
 
-        const int charPosition = blockPosition + linePos;
+        for (int linePos = clusterStart; linePos < clusterEnd && !clusterChanged; linePos++)
+        {
+            clusterChanged = d->displayedFormats.at(linePos) != format;
+        }
 
-        cursor.setPosition(charPosition, QTextCursor::MoveAnchor);
-        cursor.setPosition(charPosition + 1, QTextCursor::KeepAnchor);
-        cursor.deleteChar();
-        cursor.insertText(QString(displayedChar), charFormat);
+        if (clusterChanged)
+        {
+            d->displayedLine.replace(clusterStart, clusterEnd - clusterStart, displayedText);
+
+            for (int linePos = clusterStart; linePos < clusterEnd; linePos++)
+            {
+                d->displayedFormats[linePos] = char(format);
+            }
+
+            changed = true;
+        }
+
+        clusterStart = clusterEnd;
+    }
+
+    if (changed)
+    {
+        invalidateBlock(lineBlock(m_currentLine).blockNumber());
     }
 
-    invalidateImageCache();
     updateCursorRectangle();
-    update();
 }
 
 void LessonPainter::advanceToNextTrainingLine()
 {
+    commitDisplayedLine();
     m_currentLine++;
+    m_styledEnd = 0;
+    updateWindow();
+    resetDisplayedLine();
 
     if (m_currentLine < m_lines.length())
     {
         m_trainingLineCore->setReferenceLine(m_lines.at(m_currentLine));
+        SessionRecorder::self()->recordLine(m_currentLine);
+        m_prefetchTimer->start();
     }
     else
     {
@@ -294,19 +653,164 @@ void LessonPainter::advanceToNextTrainingLine()
 
 void LessonPainter::updateDoc()
 {
-    m_doc->clear();
+    d->textEngine.clear();
+    d->committedLines.clear();
+    m_wrapWidth = lessonWrapWidth(m_lesson, m_lines);
+    buildDoc(m_doc, m_lesson, m_lines, m_windowStart, m_windowEnd);
+    m_docSize = layoutDoc(m_doc, m_wrapWidth);
+    estimateLineHeights();
+    updateLineGeometry();
+    updateLayout();
+}
 
-    if (!m_lesson) {
-        updateLayout();
+void LessonPainter::updateWindow()
+{
+    const int lineCount = m_lines.length();
+
+    if (lineCount <= VirtualizationThreshold || !m_lesson)
+        return;
+
+    int first = qBound(0, m_currentLine, lineCount - 1);
+    int last = first;
+
+    // the current line is always part of the window, the visible lines too
+    // unless they are too far away from it
+    if (!m_visibleArea.isNull() && m_textScale > 0)
+    {
+        const int visibleFirst = lineAt(m_visibleArea.top() / m_textScale);
+        const int visibleLast = lineAt(m_visibleArea.bottom() / m_textScale);
+
+        if (qMax(last, visibleLast) - qMin(first, visibleFirst) < MaximumWindowLines)
+        {
+            first = qMin(first, visibleFirst);
+            last = qMax(last, visibleLast);
+        }
+    }
+
+    if (first >= m_windowStart && last < m_windowEnd)
         return;
+
+    m_windowStart = qMax(0, first - WindowMargin);
+    m_windowEnd = qMin(lineCount, last + 1 + WindowMargin);
+
+    buildDoc(m_doc, m_lesson, m_lines, m_windowStart, m_windowEnd);
+
+    for (int line = m_windowStart; line < m_windowEnd; line++)
+    {
+        const QHash<int, CommittedLine>::const_iterator it = d->committedLines.constFind(line);
+
+        if (it != d->committedLines.constEnd())
+        {
+            writeDisplayedLine(lineBlock(line), it.value().text, it.value().formats);
+        }
     }
 
-    m_doc->setDocumentMargin(20.0);
+    m_docSize = layoutDoc(m_doc, m_wrapWidth);
+    updateLineGeometry();
+    updateLayout();
+}
 
-    QTextCursor cursor(m_doc);
+void LessonPainter::estimateLineHeights()
+{
+    const int lineCount = m_lines.length();
+    qreal visualLineHeight = 0;
+
+    for (QTextBlock block = m_doc->begin().next(); block.isValid() && visualLineHeight == 0; block = block.next())
+    {
+        if (block.layout()->lineCount() > 0)
+        {
+            visualLineHeight = m_doc->documentLayout()->blockBoundingRect(block).height() / block.layout()->lineCount();
+        }
+    }
+
+    const qreal charWidth = QFontMetricsF(d->textCharFormat.font()).horizontalAdvance(QLatin1Char('x'));
+    const qreal textWidth = m_docSize.width() - 2 * DocumentMargin;
+    QVector<qreal> heights(lineCount);
+
+    // done once per lesson: the text is monospace, the number of wrapped
+    // lines follows from its length
+    for (int line = 0; line < lineCount; line++)
+    {
+        const int visualLines = m_paragraphMode && textWidth > 0? qMax(1, qCeil(m_lines.at(line).length() * charWidth / textWidth)): 1;
+        heights[line] = visualLines * visualLineHeight;
+    }
+
+    m_lineHeights.reset(heights);
+}
+
+void LessonPainter::updateLineGeometry()
+{
+    const int lineCount = m_lines.length();
+    const QAbstractTextDocumentLayout* docLayout = m_doc->documentLayout();
+
+    m_textTop = DocumentMargin;
+
+    // the estimates are replaced with the measured heights of the lines in the window
+    for (QTextBlock block = m_doc->begin(); block.isValid(); block = block.next())
+    {
+        const QRectF rect = docLayout->blockBoundingRect(block);
+
+        if (block.blockNumber() == 0)
+        {
+            m_textTop = rect.bottom();
+            continue;
+        }
+
+        const int line = m_windowStart + block.blockNumber() - 1;
+
+        if (line < lineCount)
+        {
+            m_lineHeights.setHeight(line, rect.height());
+        }
+    }
+
+    m_windowOffset = m_lineHeights.top(m_windowStart);
+
+    if (lineCount > 0)
+    {
+        m_docSize.setHeight(m_textTop + m_lineHeights.total() + DocumentMargin);
+    }
+}
+
+int LessonPainter::initialWindowEnd(int lineCount)
+{
+    return lineCount > VirtualizationThreshold? InitialWindowLines: lineCount;
+}
+
+int LessonPainter::lineAt(qreal y) const
+{
+    return m_lineHeights.lineAt(y - m_textTop);
+}
+
+QTextBlock LessonPainter::lineBlock(int line) const
+{
+    if (line < m_windowStart || line >= m_windowEnd)
+        return QTextBlock();
+
+    return m_doc->findBlockByNumber(line - m_windowStart + 1);
+}
+
+QRectF LessonPainter::blockRect(const QTextBlock& block) const
+{
+    const QRectF rect = m_doc->documentLayout()->blockBoundingRect(block);
+
+    // the lines of the window are shown where they are in the whole lesson
+    return block.blockNumber() > 0? rect.translated(0, m_windowOffset): rect;
+}
+
+void LessonPainter::buildDoc(QTextDocument* doc, Lesson* lesson, const QStringList& lines, int windowStart, int windowEnd) const
+{
+    doc->clear();
+
+    if (!lesson)
+        return;
+
+    doc->setDocumentMargin(DocumentMargin);
+
+    QTextCursor cursor(doc);
     QTextBlockFormat blockFormat = d->blockFormat;
 
-    const QString lessonTitle = m_lesson->title();
+    const QString lessonTitle = lesson->title();
 
     blockFormat.setAlignment(lessonTitle.isRightToLeft()? Qt::AlignRight: Qt::AlignLeft);
     cursor.setBlockFormat(blockFormat);
@@ -315,36 +819,265 @@ void LessonPainter::updateDoc()
 
     const QTextCharFormat textFormat = m_trainingLineCore? d->placeHolderCharFormat: d->textCharFormat;
 
-    foreach (const QString& line, m_lines)
+    for (int i = windowStart; i < windowEnd; i++)
     {
+        const QString& line = lines.at(i);
         blockFormat.setAlignment(line.isRightToLeft()? Qt::AlignRight: Qt::AlignLeft);
         cursor.insertBlock(d->blockFormat, textFormat);
         cursor.insertText(line);
     }
+}
 
+qreal LessonPainter::lessonWrapWidth(Lesson* lesson, const QStringList& lines) const
+{
+    const bool virtualized = lines.length() > VirtualizationThreshold;
 
-    updateLayout();
+    if (!lesson || (!m_paragraphMode && !virtualized))
+        return -1;
+
+    // paragraphs wrap at the width of the widest line of the lesson text, a
+    // window of a large lesson needs a fixed width to not change with the window
+    const QFontMetricsF metrics(d->textCharFormat.font());
+    const qreal charWidth = metrics.horizontalAdvance(QLatin1Char('x'));
+    qreal maxLineWidth = QFontMetricsF(d->titleCharFormat.font()).horizontalAdvance(lesson->title());
+
+    foreach (const QString& line, lesson->text().split('\n'))
+    {
+        maxLineWidth = qMax(maxLineWidth, virtualized? line.length() * charWidth: metrics.horizontalAdvance(line));
+    }
+
+    return qCeil(maxLineWidth + 2 * DocumentMargin);
+}
+
+QSizeF LessonPainter::layoutDoc(QTextDocument* doc, qreal wrapWidth)
+{
+    // ### reset text width from previous run
+    doc->setTextWidth(wrapWidth);
+
+    const qreal docWidth = wrapWidth > 0? wrapWidth: doc->idealWidth();
+
+    // ### without this text alignment won't work
+    if (wrapWidth <= 0)
+    {
+        doc->setTextWidth(docWidth);
+    }
+
+    return QSizeF(docWidth, doc->size().height());
+}
+
+void LessonPainter::clearTrainingStatus()
+{
+    if (!m_trainingLineCore)
+        return;
+
+    QTextCursor cursor(m_doc);
+
+    // restore the reference text of every line touched in the last run
+    for (int line = m_windowStart; line <= qMin(m_currentLine, m_windowEnd - 1); line++)
+    {
+        const QTextBlock block = lineBlock(line);
+        cursor.setPosition(block.position(), QTextCursor::MoveAnchor);
+        cursor.setPosition(block.position() + block.length() - 1, QTextCursor::KeepAnchor);
+        cursor.insertText(m_lines.at(line), d->placeHolderCharFormat);
+    }
+
+    d->committedLines.clear();
+
+    invalidateImageCache();
+}
+
+void LessonPainter::resetDisplayedLine()
+{
+    // a line that hasn't been trained yet shows the placeholder text it was built with
+    d->displayedLine = m_currentLine < m_lines.length()? m_lines.at(m_currentLine): QString();
+    d->displayedFormats = QByteArray(d->displayedLine.length(), char(LessonPainterPrivate::PlaceHolderFormat));
+    d->textEngine.shapeLine(m_currentLine, lineBlock(m_currentLine));
+}
+
+void LessonPainter::commitDisplayedLine()
+{
+    const QTextBlock block = lineBlock(m_currentLine);
+
+    if (!block.isValid())
+        return;
+
+    d->committedLines.insert(m_currentLine, {d->displayedLine, d->displayedFormats});
+    writeDisplayedLine(block, d->displayedLine, d->displayedFormats);
+    invalidateBlock(block.blockNumber());
+}
+
+void LessonPainter::writeDisplayedLine(const QTextBlock& block, const QString& text, const QByteArray& formats)
+{
+    const int length = qMin(qMin(text.length(), formats.length()), block.length() - 1);
+    QTextCursor cursor(m_doc);
+    int runStart = 0;
+
+    // the finished line is written to the document in one edit, with one
+    // fragment per run of equally formatted characters
+    cursor.beginEditBlock();
+
+    for (int linePos = 1; linePos <= length; linePos++)
+    {
+        if (linePos < length && formats.at(linePos) == formats.at(runStart))
+            continue;
+
+        cursor.setPosition(block.position() + runStart, QTextCursor::MoveAnchor);
+        cursor.setPosition(block.position() + linePos, QTextCursor::KeepAnchor);
+        cursor.insertText(text.mid(runStart, linePos - runStart), d->displayedCharFormats.at(formats.at(runStart)));
+        runStart = linePos;
+    }
+
+    cursor.endEditBlock();
+}
+
+bool LessonPainter::isTrainingBlock(const QTextBlock& block) const
+{
+    return m_trainingLineCore && block == lineBlock(m_currentLine) && d->textEngine.isShaped(m_currentLine);
+}
+
+LessonGlyphs LessonPainter::blockGlyphs(const QTextBlock& block) const
+{
+    if (isTrainingBlock(block))
+        return d->textEngine.glyphs(m_currentLine, d->displayedLine, d->displayedFormats, d->displayedCharFormats);
+
+    return LessonGlyphs::fromBlock(block);
+}
+
+void LessonPainter::prefetch()
+{
+    if (m_trainingLineCore && m_currentLine + 1 < m_lines.length())
+    {
+        m_trainingLineCore->prefetchReferenceLine(m_lines.at(m_currentLine + 1));
+        d->textEngine.shapeLine(m_currentLine + 1, lineBlock(m_currentLine + 1));
+    }
+
+    if (!m_nextLesson || m_nextLesson == m_lesson)
+        return;
+
+    LessonSource source;
+    source.title = m_nextLesson->title();
+    source.text = m_nextLesson->text();
+    source.paragraphMode = m_paragraphMode;
+    source.training = m_trainingLineCore != 0;
+
+    if (source == d->nextDocSource)
+        return;
+
+    // build and lay out the next lesson now, so starting it only swaps documents
+    d->nextDocSource = source;
+    d->nextDocLines = trainingUnits(source.text, m_paragraphMode);
+    d->nextDocWindowEnd = initialWindowEnd(d->nextDocLines.length());
+    d->nextDocWrapWidth = lessonWrapWidth(m_nextLesson, d->nextDocLines);
+    buildDoc(m_nextDoc, m_nextLesson, d->nextDocLines, 0, d->nextDocWindowEnd);
+    d->nextDocSize = layoutDoc(m_nextDoc, d->nextDocWrapWidth);
 }
 
 void LessonPainter::invalidateImageCache()
 {
-    m_imageCacheDirty = true;
-    m_imageCache = QImage();
+    d->tiles.clear();
+    update();
+    emit contentInvalidated();
+}
+
+void LessonPainter::invalidateBlock(int blockNumber)
+{
+    emit blockInvalidated(blockNumber);
+
+    const QTextBlock block = m_doc->findBlockByNumber(blockNumber);
+
+    if (!block.isValid())
+        return;
+
+    const QRectF blockRect = this->blockRect(block);
+    const LessonTile tile = d->tiles.take(blockNumber);
+
+    // the blocks below move when the edited one changes its height
+    if (tile.image.isNull() || tile.blockRect != blockRect)
+    {
+        update();
+        return;
+    }
+
+    const QRectF itemRect(blockRect.topLeft() * m_textScale, blockRect.size() * m_textScale);
+    update(itemRect.translated(0, -y()).toAlignedRect());
+}
+
+void LessonPainter::setContentHeight(qreal contentHeight)
+{
+    if (contentHeight != m_contentHeight)
+    {
+        m_contentHeight = contentHeight;
+        emit contentHeightChanged();
+    }
+
+    updatePaintedArea();
+}
+
+QRectF LessonPainter::contentRect() const
+{
+    return QRectF(0, 0, width(), m_contentHeight);
+}
+
+QRectF LessonPainter::retainedArea() const
+{
+    if (m_visibleArea.isNull())
+        return contentRect();
+
+    // keep one screen above and below the visible area ready for scrolling
+    const qreal margin = m_visibleArea.height();
+    return m_visibleArea.adjusted(0, -margin, 0, margin) & contentRect();
+}
+
+void LessonPainter::dropDistantTiles()
+{
+    const QRectF retained = retainedArea();
+
+    // tiles scrolled out of reach are dropped right away, the pixels of the
+    // lesson beyond the painted area are only held by the retained tiles
+    for (QHash<int, LessonTile>::iterator it = d->tiles.begin(); it != d->tiles.end();)
+    {
+        const QRectF blockRect = it.value().blockRect;
+        const QRectF itemRect(blockRect.topLeft() * m_textScale, blockRect.size() * m_textScale);
+
+        if (itemRect.intersects(retained))
+        {
+            ++it;
+        }
+        else
+        {
+            it = d->tiles.erase(it);
+        }
+    }
 }
 
-void LessonPainter::checkImageCache()
+void LessonPainter::updatePaintedArea()
 {
-    if (!m_imageCacheDirty)
+    const QRectF paintedArea(0, y(), width(), height());
+    QRectF visibleArea = m_visibleArea.isNull()? contentRect(): m_visibleArea & contentRect();
+
+    // a hidden painter doesn't need a backing image
+    if (!isVisible())
+    {
+        visibleArea = QRectF();
+    }
+
+    if (!visibleArea.isEmpty() && paintedArea.contains(visibleArea) && paintedArea.bottom() <= m_contentHeight)
         return;
 
-    QImage img(QSize(qFloor(width()), qFloor(height())), QImage::Format_ARGB32_Premultiplied);
-    img.fill(Qt::transparent);
-    QPainter painter(&img);
-    painter.scale(m_textScale, m_textScale);
-    m_doc->drawContents(&painter);
+    // the item only covers the visible area and half a screen above and below
+    // it, so its backing image doesn't grow with the lesson; while scrolling it
+    // is moved along and repainted from the tiles
+    const qreal margin = m_visibleArea.isNull()? 0: m_visibleArea.height() / 2;
+    const QRectF area = visibleArea.isEmpty()? QRectF(): visibleArea.adjusted(0, -margin, 0, margin) & contentRect();
+    const qreal top = qFloor(area.top());
+    const qreal height = qCeil(area.bottom()) - top;
 
-    m_imageCache = img;
-    m_imageCacheDirty = false;
+    if (top == y() && height == this->height())
+        return;
+
+    setY(top);
+    setHeight(height);
+    update();
 }
 
 void LessonPainter::updateCursorRectangle()
@@ -354,18 +1087,23 @@ void LessonPainter::updateCursorRectangle()
 
     const QString actualLine = m_trainingLineCore->actualLine();
     const QString preeditString = m_trainingLineCore->preeditString();
-    const QTextBlock block = m_doc->findBlockByNumber(m_currentLine + 1);
-    const QAbstractTextDocumentLayout* docLayout = m_doc->documentLayout();
-    const QTextLayout* layout = block.layout();
-    const QPointF blockPos = docLayout->blockBoundingRect(block).topLeft();
+    const QTextBlock block = lineBlock(m_currentLine);
+
+    if (!block.isValid())
+        return;
+
+    const QPointF blockPos = blockRect(block).topLeft();
     const int relCursorPos = actualLine.length() + preeditString.length();
-    const QTextLine line = layout->lineForTextPosition(relCursorPos);
+
+    // the geometry comes from the advances cached when the line was shaped
+    d->textEngine.shapeLine(m_currentLine, block);
+    const QRectF cursorRect = d->textEngine.cursorRectangle(m_currentLine, relCursorPos);
 
     m_cursorRectangle = QRectF(
-                m_textScale * (blockPos.x() + line.cursorToX(relCursorPos)),
-                m_textScale * (blockPos.y() + line.y()),
+                m_textScale * (blockPos.x() + cursorRect.x()),
+                m_textScale * (blockPos.y() + cursorRect.y()),
                 1,
-                m_textScale * (line.height()));
+                m_textScale * (cursorRect.height()));
 
     emit cursorRectangleChanged();
 }
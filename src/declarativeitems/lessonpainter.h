@@ -19,29 +19,38 @@
 #define LESSONPAINTER_H
 
 #include <QQuickPaintedItem>
-#include <QImage>
 
 #include <QPointer>
 
+#include "declarativeitems/lineheights.h"
+
+class QTextBlock;
 class QTextDocument;
+class QTimer;
 
 class Lesson;
 class TrainingLineCore;
+struct LessonGlyphs;
 struct LessonPainterPrivate;
 
 class LessonPainter : public QQuickPaintedItem
 {
     Q_OBJECT
     Q_PROPERTY(Lesson* lesson READ lesson WRITE setLesson NOTIFY lessonChanged)
+    Q_PROPERTY(Lesson* nextLesson READ nextLesson WRITE setNextLesson NOTIFY nextLessonChanged)
     Q_PROPERTY(qreal maximumWidth READ maximumWidth WRITE setMaximumWidth NOTIFY maximumWidthChanged)
     Q_PROPERTY(qreal maximumHeight READ maximumHeight WRITE setMaximumHeight NOTIFY maximumHeightChanged)
     Q_PROPERTY(TrainingLineCore* trainingLineCore READ trainingLineCore WRITE setTrainingLineCore NOTIFY trainingLineCoreChanged)
     Q_PROPERTY(QRectF cursorRectangle READ cursorRectangle NOTIFY cursorRectangleChanged)
+    Q_PROPERTY(QRectF visibleArea READ visibleArea WRITE setVisibleArea NOTIFY visibleAreaChanged)
+    Q_PROPERTY(qreal contentHeight READ contentHeight NOTIFY contentHeightChanged)
 public:
     explicit LessonPainter(QQuickItem* parent = 0);
     ~LessonPainter();
     Lesson* lesson() const;
     void setLesson(Lesson* lesson);
+    Lesson* nextLesson() const;
+    void setNextLesson(Lesson* nextLesson);
     qreal maximumWidth() const;
     void setMaximumWidth(qreal maximumWidth);
     qreal maximumHeight() const;
@@ -49,36 +58,86 @@ public:
     TrainingLineCore* trainingLineCore() const;
     void setTrainingLineCore(TrainingLineCore* trainingLineCore);
     QRectF cursorRectangle() const;
+    QRectF visibleArea() const;
+    void setVisibleArea(const QRectF& visibleArea);
+    qreal contentHeight() const;
+    int currentLine() const;
+    qreal textScale() const;
+    int blockCount() const;
+    QPointF blockPosition(int blockNumber) const;
+    LessonGlyphs blockGlyphs(int blockNumber) const;
+    static QStringList trainingUnits(const QString& text, bool paragraphs);
 public slots:
     void reset();
 signals:
     void lessonChanged();
+    void nextLessonChanged();
     void maximumWidthChanged();
     void maximumHeightChanged();
     void trainingLineCoreChanged();
     void cursorRectangleChanged();
+    void visibleAreaChanged();
+    void contentHeightChanged();
     void done();
+    void contentInvalidated();
+    void blockInvalidated(int blockNumber);
 protected:
     void paint(QPainter* painter) override;
+    void itemChange(ItemChange change, const ItemChangeData& value) override;
 private slots:
     void updateLayout();
     void resetTrainingStatus();
     void updateTrainingStatus();
+    void updateTrainingStatusSpan(int start, int end);
     void advanceToNextTrainingLine();
+    void prefetch();
 private:
     void updateDoc();
+    void updateWindow();
+    void estimateLineHeights();
+    void updateLineGeometry();
+    static int initialWindowEnd(int lineCount);
+    int lineAt(qreal y) const;
+    QTextBlock lineBlock(int line) const;
+    QRectF blockRect(const QTextBlock& block) const;
+    void buildDoc(QTextDocument* doc, Lesson* lesson, const QStringList& lines, int windowStart, int windowEnd) const;
+    qreal lessonWrapWidth(Lesson* lesson, const QStringList& lines) const;
+    static QSizeF layoutDoc(QTextDocument* doc, qreal wrapWidth);
+    void clearTrainingStatus();
+    void resetDisplayedLine();
+    void commitDisplayedLine();
+    void writeDisplayedLine(const QTextBlock& block, const QString& text, const QByteArray& formats);
+    bool isTrainingBlock(const QTextBlock& block) const;
+    LessonGlyphs blockGlyphs(const QTextBlock& block) const;
     void invalidateImageCache();
-    void checkImageCache();
+    void invalidateBlock(int blockNumber);
+    void setContentHeight(qreal contentHeight);
+    QRectF contentRect() const;
+    QRectF retainedArea() const;
+    void dropDistantTiles();
+    void updatePaintedArea();
     void updateCursorRectangle();
     LessonPainterPrivate* d;
     QPointer<Lesson> m_lesson;
+    QPointer<Lesson> m_nextLesson;
     QStringList m_lines;
     QTextDocument* m_doc;
+    QTextDocument* m_nextDoc;
+    QSizeF m_docSize;
     qreal m_textScale;
+    bool m_paragraphMode;
+    qreal m_wrapWidth;
+    int m_styledEnd;
+    int m_windowStart;
+    int m_windowEnd;
+    LineHeights m_lineHeights;
+    qreal m_textTop;
+    qreal m_windowOffset;
+    QTimer* m_prefetchTimer;
     qreal m_maximumWidth;
     qreal m_maximumHeight;
-    QImage m_imageCache;
-    bool m_imageCacheDirty;
+    QRectF m_visibleArea;
+    qreal m_contentHeight;
     TrainingLineCore* m_trainingLineCore;
     int m_currentLine;
     QPointer<QQuickItem> m_cursorItem;
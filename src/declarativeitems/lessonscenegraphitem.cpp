@@ -0,0 +1,258 @@
+/*
+ *  Copyright 2026  The KTouch Developers <kde-edu@kde.org>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "lessonscenegraphitem.h"
+
+#include <QQuickWindow>
+
+#include "bindings/latencymonitor.h"
+#include "declarativeitems/lessonpainter.h"
+#include "declarativeitems/lessontextengine.h"
+
+static void appendColoredRect(QVector<QSGGeometry::ColoredPoint2D>& vertices, const QRectF& rect, const QColor& color)
+{
+    // the vertex color material expects premultiplied colors
+    const QRgb rgba = qPremultiply(color.rgba());
+    QSGGeometry::ColoredPoint2D topLeft, topRight, bottomLeft, bottomRight;
+
+    topLeft.set(rect.left(), rect.top(), qRed(rgba), qGreen(rgba), qBlue(rgba), qAlpha(rgba));
+    topRight.set(rect.right(), rect.top(), qRed(rgba), qGreen(rgba), qBlue(rgba), qAlpha(rgba));
+    bottomLeft.set(rect.left(), rect.bottom(), qRed(rgba), qGreen(rgba), qBlue(rgba), qAlpha(rgba));
+    bottomRight.set(rect.right(), rect.bottom(), qRed(rgba), qGreen(rgba), qBlue(rgba), qAlpha(rgba));
+
+    vertices << topLeft << topRight << bottomLeft << topRight << bottomRight << bottomLeft;
+}
+
+static void appendTexturedRect(QVector<QSGGeometry::TexturedPoint2D>& vertices, const QRectF& rect, const QRect& sourceRect)
+{
+    QSGGeometry::TexturedPoint2D topLeft, topRight, bottomLeft, bottomRight;
+
+    topLeft.set(rect.left(), rect.top(), sourceRect.left(), sourceRect.top());
+    topRight.set(rect.right(), rect.top(), sourceRect.left() + sourceRect.width(), sourceRect.top());
+    bottomLeft.set(rect.left(), rect.bottom(), sourceRect.left(), sourceRect.top() + sourceRect.height());
+    bottomRight.set(rect.right(), rect.bottom(), sourceRect.left() + sourceRect.width(), sourceRect.top() + sourceRect.height());
+
+    vertices << topLeft << topRight << bottomLeft << topRight << bottomRight << bottomLeft;
+}
+
+LessonSceneGraphItem::LessonSceneGraphItem(QQuickItem* parent) :
+    QQuickItem(parent),
+    m_contentDirty(true),
+    m_dirtyBlockStart(-1),
+    m_dirtyBlockEnd(-1),
+    m_nodeDirty(true),
+    m_changedBlockStart(-1),
+    m_changedBlockEnd(-1)
+{
+    setFlag(QQuickItem::ItemHasContents, true);
+}
+
+LessonPainter* LessonSceneGraphItem::lessonPainter() const
+{
+    return m_lessonPainter;
+}
+
+void LessonSceneGraphItem::setLessonPainter(LessonPainter* lessonPainter)
+{
+    if (lessonPainter != m_lessonPainter)
+    {
+        if (m_lessonPainter)
+        {
+            m_lessonPainter->disconnect(this);
+        }
+
+        m_lessonPainter = lessonPainter;
+
+        if (m_lessonPainter)
+        {
+            connect(m_lessonPainter, &LessonPainter::contentInvalidated, this, &LessonSceneGraphItem::invalidateContent);
+            connect(m_lessonPainter, &LessonPainter::blockInvalidated, this, &LessonSceneGraphItem::invalidateBlock);
+        }
+
+        invalidateContent();
+        emit lessonPainterChanged();
+    }
+}
+
+void LessonSceneGraphItem::itemChange(ItemChange change, const ItemChangeData& value)
+{
+    QQuickItem::itemChange(change, value);
+
+    if (change == ItemDevicePixelRatioHasChanged)
+    {
+        invalidateContent();
+    }
+}
+
+void LessonSceneGraphItem::updatePolish()
+{
+    QQuickItem::updatePolish();
+
+    const qreal textScale = m_lessonPainter? m_lessonPainter->textScale(): 1.0;
+    const int blockCount = m_lessonPainter? m_lessonPainter->blockCount(): 0;
+
+    if (m_atlas.setScale(textScale, window()->effectiveDevicePixelRatio()) || m_blocks.count() != blockCount)
+    {
+        m_contentDirty = true;
+    }
+
+    if (m_contentDirty)
+    {
+        m_blocks.fill(LessonBlockGeometry(), blockCount);
+        m_dirtyBlockStart = 0;
+        m_dirtyBlockEnd = blockCount - 1;
+        m_contentDirty = false;
+        m_nodeDirty = true;
+    }
+
+    prepareBlocks();
+
+    if (m_atlas.hasOverflowed())
+    {
+        // start over with only the glyphs of the current blocks
+        m_atlas.clear();
+        m_dirtyBlockStart = 0;
+        m_dirtyBlockEnd = blockCount - 1;
+        prepareBlocks();
+    }
+}
+
+QSGNode* LessonSceneGraphItem::updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData* data)
+{
+    Q_UNUSED(data)
+
+    LessonNode* node = static_cast<LessonNode*>(oldNode);
+
+    if (!node)
+    {
+        node = new LessonNode();
+        m_nodeDirty = true;
+    }
+
+    // the glyphs were rasterized on the GUI thread, only the atlas is uploaded here
+    if (node->atlasRevision() != m_atlas.revision())
+    {
+        if (node->setAtlas(window()->createTextureFromImage(m_atlas.image()), m_atlas.revision()))
+        {
+            m_changedBlockStart = 0;
+            m_changedBlockEnd = m_blocks.count() - 1;
+        }
+    }
+
+    if (m_nodeDirty || node->blockCount() != m_blocks.count())
+    {
+        node->setBlockCount(m_blocks.count());
+        m_changedBlockStart = 0;
+        m_changedBlockEnd = m_blocks.count() - 1;
+    }
+
+    for (int i = qMax(0, m_changedBlockStart); i <= m_changedBlockEnd; i++)
+    {
+        node->updateBlock(i, m_blocks.at(i));
+    }
+
+    m_nodeDirty = false;
+    m_changedBlockStart = -1;
+    m_changedBlockEnd = -1;
+
+    LatencyMonitor::self()->markPaint();
+
+    return node;
+}
+
+void LessonSceneGraphItem::invalidateContent()
+{
+    m_contentDirty = true;
+    polish();
+    update();
+}
+
+void LessonSceneGraphItem::invalidateBlock(int blockNumber)
+{
+    m_dirtyBlockStart = m_dirtyBlockStart == -1? blockNumber: qMin(m_dirtyBlockStart, blockNumber);
+    m_dirtyBlockEnd = qMax(m_dirtyBlockEnd, blockNumber);
+    polish();
+    update();
+}
+
+void LessonSceneGraphItem::prepareBlocks()
+{
+    if (m_dirtyBlockStart == -1)
+        return;
+
+    // only the blocks whose formats changed are built again, plus the blocks
+    // below them if a changed block has grown or shrunk
+    for (int i = m_dirtyBlockStart; i < m_blocks.count(); i++)
+    {
+        const QPointF position = m_lessonPainter->blockPosition(i);
+
+        if (i > m_dirtyBlockEnd && position == m_blocks.at(i).position)
+            break;
+
+        prepareBlock(i, m_lessonPainter->blockGlyphs(i), position);
+        m_changedBlockStart = m_changedBlockStart == -1? i: qMin(m_changedBlockStart, i);
+        m_changedBlockEnd = qMax(m_changedBlockEnd, i);
+    }
+
+    m_dirtyBlockStart = -1;
+    m_dirtyBlockEnd = -1;
+}
+
+void LessonSceneGraphItem::prepareBlock(int index, const LessonGlyphs& glyphs, const QPointF& position)
+{
+    LessonBlockGeometry& block = m_blocks[index];
+    const qreal scale = m_atlas.scale();
+    const qreal ratio = m_atlas.devicePixelRatio();
+
+    block.position = position;
+    block.backgrounds.clear();
+    block.glyphs.clear();
+    block.underlines.clear();
+
+    foreach (const LessonGlyphs::Rect& background, glyphs.backgrounds)
+    {
+        const QRectF rect = background.rect.translated(position);
+        appendColoredRect(block.backgrounds, QRectF(rect.topLeft() * scale, rect.size() * scale), background.color);
+    }
+
+    foreach (const LessonGlyphs::Run& run, glyphs.runs)
+    {
+        const int style = m_atlas.glyphStyle(run.glyphRun.rawFont(), run.color);
+        const QVector<quint32> glyphIndexes = run.glyphRun.glyphIndexes();
+        const QVector<QPointF> positions = run.glyphRun.positions();
+
+        for (int i = 0; i < glyphIndexes.count(); i++)
+        {
+            const LessonGlyphAtlas::Glyph& glyph = m_atlas.glyph(style, glyphIndexes.at(i));
+
+            if (glyph.rect.isEmpty())
+                continue;
+
+            // snap the glyph origin to device pixels, the atlas is never scaled
+            const QPointF origin = (position + positions.at(i)) * scale * ratio;
+            const QPointF topLeft = QPointF(qRound(origin.x()) + glyph.offset.x(), qRound(origin.y()) + glyph.offset.y()) / ratio;
+            appendTexturedRect(block.glyphs, QRectF(topLeft, QSizeF(glyph.rect.size()) / ratio), glyph.rect);
+        }
+    }
+
+    foreach (const LessonGlyphs::Rect& underline, glyphs.underlines)
+    {
+        const QRectF rect = underline.rect.translated(position);
+        const qreal height = qMax(1 / ratio, rect.height() * scale);
+        appendColoredRect(block.underlines, QRectF(rect.topLeft() * scale, QSizeF(rect.width() * scale, height)), underline.color);
+    }
+}
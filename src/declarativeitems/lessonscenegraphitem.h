@@ -0,0 +1,64 @@
+/*
+ *  Copyright 2026  The KTouch Developers <kde-edu@kde.org>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LESSONSCENEGRAPHITEM_H
+#define LESSONSCENEGRAPHITEM_H
+
+#include <QQuickItem>
+
+#include <QPointer>
+#include <QVector>
+
+#include "declarativeitems/lessonglyphatlas.h"
+#include "declarativeitems/lessonnode.h"
+
+class LessonPainter;
+
+struct LessonGlyphs;
+
+class LessonSceneGraphItem : public QQuickItem
+{
+    Q_OBJECT
+    Q_PROPERTY(LessonPainter* lessonPainter READ lessonPainter WRITE setLessonPainter NOTIFY lessonPainterChanged)
+public:
+    explicit LessonSceneGraphItem(QQuickItem* parent = 0);
+    LessonPainter* lessonPainter() const;
+    void setLessonPainter(LessonPainter* lessonPainter);
+signals:
+    void lessonPainterChanged();
+protected:
+    void itemChange(ItemChange change, const ItemChangeData& value) override;
+    void updatePolish() override;
+    QSGNode* updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData* data) override;
+private slots:
+    void invalidateContent();
+    void invalidateBlock(int blockNumber);
+private:
+    void prepareBlocks();
+    void prepareBlock(int index, const LessonGlyphs& glyphs, const QPointF& position);
+    QPointer<LessonPainter> m_lessonPainter;
+    LessonGlyphAtlas m_atlas;
+    QVector<LessonBlockGeometry> m_blocks;
+    bool m_contentDirty;
+    int m_dirtyBlockStart;
+    int m_dirtyBlockEnd;
+    bool m_nodeDirty;
+    int m_changedBlockStart;
+    int m_changedBlockEnd;
+};
+
+#endif // LESSONSCENEGRAPHITEM_H
@@ -0,0 +1,284 @@
+/*
+ *  Copyright 2026  The KTouch Developers <kde-edu@kde.org>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "lessontextengine.h"
+
+#include <QAbstractTextDocumentLayout>
+#include <QFontMetricsF>
+#include <QPainter>
+#include <QTextBlock>
+#include <QTextCharFormat>
+#include <QTextDocument>
+#include <QTextLayout>
+
+#include "declarativeitems/traininglinecore.h"
+
+static void appendDecorations(LessonGlyphs& glyphs, const QTextCharFormat& format, const QRectF& rect, qreal underlineY, qreal lineWidth)
+{
+    if (format.background().style() != Qt::NoBrush)
+    {
+        glyphs.backgrounds.append({rect, format.background().color()});
+    }
+
+    if (format.underlineStyle() != QTextCharFormat::NoUnderline)
+    {
+        const QColor color = format.underlineColor().isValid()? format.underlineColor(): format.foreground().color();
+        glyphs.underlines.append({QRectF(rect.left(), underlineY, rect.width(), lineWidth), color});
+    }
+}
+
+LessonGlyphs LessonGlyphs::fromBlock(const QTextBlock& block)
+{
+    LessonGlyphs glyphs;
+    const QTextLayout* layout = block.layout();
+
+    for (QTextBlock::iterator it = block.begin(); !it.atEnd(); ++it)
+    {
+        const QTextFragment fragment = it.fragment();
+
+        if (!fragment.isValid())
+            continue;
+
+        const QTextCharFormat format = fragment.charFormat();
+        const QColor color = format.foreground().color();
+
+        if (format.background().style() != Qt::NoBrush || format.underlineStyle() != QTextCharFormat::NoUnderline)
+        {
+            const int start = fragment.position() - block.position();
+            const int end = start + fragment.length();
+            const QFontMetricsF metrics(format.font());
+
+            for (int i = 0; i < layout->lineCount(); i++)
+            {
+                const QTextLine line = layout->lineAt(i);
+                const int lineStart = qMax(start, line.textStart());
+                const int lineEnd = qMin(end, line.textStart() + line.textLength());
+
+                if (lineStart >= lineEnd)
+                    continue;
+
+                const qreal x1 = line.cursorToX(lineStart);
+                const qreal x2 = line.cursorToX(lineEnd);
+                const QRectF rect(qMin(x1, x2), line.y(), qAbs(x2 - x1), line.height());
+                appendDecorations(glyphs, format, rect, line.y() + line.ascent() + metrics.underlinePos(), metrics.lineWidth());
+            }
+        }
+
+        foreach (const QGlyphRun& glyphRun, fragment.glyphRuns())
+        {
+            glyphs.runs.append({glyphRun, color});
+        }
+    }
+
+    return glyphs;
+}
+
+void LessonGlyphs::paint(QPainter* painter) const
+{
+    foreach (const Rect& background, backgrounds)
+    {
+        painter->fillRect(background.rect, background.color);
+    }
+
+    foreach (const Run& run, runs)
+    {
+        painter->setPen(run.color);
+        painter->drawGlyphRun(QPointF(0, 0), run.glyphRun);
+    }
+
+    foreach (const Rect& underline, underlines)
+    {
+        painter->fillRect(underline.rect, underline.color);
+    }
+}
+
+LessonTextEngine::LessonTextEngine() :
+    m_underlinePosition(0),
+    m_lineWidth(1)
+{
+}
+
+void LessonTextEngine::clear()
+{
+    m_lines.clear();
+    m_texts.clear();
+}
+
+bool LessonTextEngine::isShaped(int lessonLine) const
+{
+    return m_lines.contains(lessonLine);
+}
+
+void LessonTextEngine::shapeLine(int lessonLine, const QTextBlock& block)
+{
+    if (!block.isValid() || isShaped(lessonLine))
+        return;
+
+    // the document is laid out lazily, asking for the geometry of the block makes sure it is
+    block.document()->documentLayout()->blockBoundingRect(block);
+
+    const QTextLayout* layout = block.layout();
+    const QTextCharFormat format = block.begin().atEnd()? block.charFormat(): block.begin().fragment().charFormat();
+
+    if (format.font() != m_font)
+    {
+        // the shapes are kept per lesson line for as long as the font stays the
+        // same, the text scale is applied later and doesn't change them
+        m_font = format.font();
+        m_lines.clear();
+        m_texts.clear();
+
+        const QFontMetricsF metrics(m_font);
+        m_underlinePosition = metrics.underlinePos();
+        m_lineWidth = metrics.lineWidth();
+    }
+
+    ShapedLine shapedLine;
+    shapedLine.text = block.text();
+
+    const int length = shapedLine.text.length();
+    QVector<int> clusterStarts;
+    QVector<int> wordBoundaries;
+    TrainingLineCore::computeBoundaryTables(shapedLine.text, clusterStarts, shapedLine.clusterEnds, wordBoundaries);
+
+    for (int i = 0; i < layout->lineCount(); i++)
+    {
+        const QTextLine line = layout->lineAt(i);
+        shapedLine.lines.append({line.y(), line.height(), line.ascent()});
+    }
+
+    // everything the keystroke path needs is taken from the layout once: the
+    // glyphs of every cluster and the cursor position in front of every character
+    shapedLine.clusterGlyphs.resize(length);
+    shapedLine.cursorX.resize(length + 1);
+    shapedLine.lineIndexes.resize(length + 1);
+
+    for (int position = 0; position <= length; position++)
+    {
+        const QTextLine line = layout->lineForTextPosition(position);
+
+        if (!line.isValid())
+            continue;
+
+        shapedLine.cursorX[position] = line.cursorToX(position);
+        shapedLine.lineIndexes[position] = line.lineNumber();
+
+        if (position < length && clusterStarts.at(position) == position)
+        {
+            shapedLine.clusterGlyphs[position] = line.glyphRuns(position, shapedLine.clusterEnds.at(position) - position);
+        }
+    }
+
+    m_lines.insert(lessonLine, shapedLine);
+}
+
+LessonGlyphs LessonTextEngine::glyphs(int lessonLine, const QString& displayedLine, const QByteArray& displayedFormats, const QVector<QTextCharFormat>& charFormats) const
+{
+    LessonGlyphs glyphs;
+    const QHash<int, ShapedLine>::const_iterator it = m_lines.constFind(lessonLine);
+
+    if (it == m_lines.constEnd())
+        return glyphs;
+
+    const ShapedLine& shapedLine = it.value();
+    const int length = qMin(shapedLine.text.length(), qMin(displayedLine.length(), displayedFormats.length()));
+    int clusterStart = 0;
+
+    glyphs.runs.reserve(length);
+
+    while (clusterStart < length)
+    {
+        const int clusterEnd = qMin(length, qMax(clusterStart + 1, shapedLine.clusterEnds.at(clusterStart)));
+        const QTextCharFormat& format = charFormats.at(displayedFormats.at(clusterStart));
+        const QColor color = format.foreground().color();
+        const LineMetrics& line = shapedLine.lines.at(shapedLine.lineIndexes.at(clusterStart));
+        const qreal x1 = shapedLine.cursorX.at(clusterStart);
+        const qreal x2 = shapedLine.cursorX.at(clusterEnd);
+        const QRectF rect(qMin(x1, x2), line.y, qAbs(x2 - x1), line.height);
+        const QStringRef displayedText = displayedLine.midRef(clusterStart, clusterEnd - clusterStart);
+
+        appendDecorations(glyphs, format, rect, line.y + line.ascent + m_underlinePosition, m_lineWidth);
+
+        if (displayedText == shapedLine.text.midRef(clusterStart, clusterEnd - clusterStart))
+        {
+            foreach (const QGlyphRun& glyphRun, shapedLine.clusterGlyphs.at(clusterStart))
+            {
+                glyphs.runs.append({glyphRun, color});
+            }
+        }
+        else
+        {
+            // typed and preedit characters take the place of the reference cluster
+            const ShapedText& shapedText = shapeText(displayedText.toString());
+            const QPointF offset(rect.left(), line.y + line.ascent - shapedText.ascent);
+
+            foreach (QGlyphRun glyphRun, shapedText.glyphRuns)
+            {
+                QVector<QPointF> positions = glyphRun.positions();
+
+                for (int i = 0; i < positions.count(); i++)
+                {
+                    positions[i] += offset;
+                }
+
+                glyphRun.setPositions(positions);
+                glyphs.runs.append({glyphRun, color});
+            }
+        }
+
+        clusterStart = clusterEnd;
+    }
+
+    return glyphs;
+}
+
+QRectF LessonTextEngine::cursorRectangle(int lessonLine, int position) const
+{
+    const QHash<int, ShapedLine>::const_iterator it = m_lines.constFind(lessonLine);
+
+    if (it == m_lines.constEnd() || it.value().lines.isEmpty())
+        return QRectF();
+
+    const ShapedLine& shapedLine = it.value();
+    position = qBound(0, position, shapedLine.text.length());
+    const LineMetrics& line = shapedLine.lines.at(shapedLine.lineIndexes.at(position));
+
+    return QRectF(shapedLine.cursorX.at(position), line.y, 0, line.height);
+}
+
+const LessonTextEngine::ShapedText& LessonTextEngine::shapeText(const QString& text) const
+{
+    const QHash<QString, ShapedText>::const_iterator it = m_texts.constFind(text);
+
+    if (it != m_texts.constEnd())
+        return it.value();
+
+    QTextOption option;
+    option.setUseDesignMetrics(true);
+
+    QTextLayout layout(text, m_font);
+    layout.setTextOption(option);
+    layout.beginLayout();
+    const QTextLine line = layout.createLine();
+    layout.endLayout();
+
+    ShapedText shapedText;
+    shapedText.glyphRuns = layout.glyphRuns();
+    shapedText.ascent = line.isValid()? line.ascent(): 0;
+
+    return m_texts.insert(text, shapedText).value();
+}
@@ -0,0 +1,100 @@
+/*
+ *  Copyright 2026  The KTouch Developers <kde-edu@kde.org>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LESSONTEXTENGINE_H
+#define LESSONTEXTENGINE_H
+
+#include <QByteArray>
+#include <QColor>
+#include <QFont>
+#include <QGlyphRun>
+#include <QHash>
+#include <QList>
+#include <QRectF>
+#include <QString>
+#include <QVector>
+
+class QPainter;
+class QTextBlock;
+class QTextCharFormat;
+
+// the glyphs and decorations of a text block, relative to the position of its layout
+struct LessonGlyphs
+{
+    struct Run
+    {
+        QGlyphRun glyphRun;
+        QColor color;
+    };
+
+    struct Rect
+    {
+        QRectF rect;
+        QColor color;
+    };
+
+    QVector<Run> runs;
+    QVector<Rect> backgrounds;
+    QVector<Rect> underlines;
+
+    static LessonGlyphs fromBlock(const QTextBlock& block);
+    void paint(QPainter* painter) const;
+};
+
+class LessonTextEngine
+{
+public:
+    LessonTextEngine();
+    void clear();
+    bool isShaped(int lessonLine) const;
+    void shapeLine(int lessonLine, const QTextBlock& block);
+    LessonGlyphs glyphs(int lessonLine, const QString& displayedLine, const QByteArray& displayedFormats, const QVector<QTextCharFormat>& charFormats) const;
+    QRectF cursorRectangle(int lessonLine, int position) const;
+
+private:
+    struct LineMetrics
+    {
+        qreal y;
+        qreal height;
+        qreal ascent;
+    };
+
+    struct ShapedLine
+    {
+        QString text;
+        QVector<int> clusterEnds;
+        QVector<QList<QGlyphRun> > clusterGlyphs;
+        QVector<qreal> cursorX;
+        QVector<int> lineIndexes;
+        QVector<LineMetrics> lines;
+    };
+
+    struct ShapedText
+    {
+        QList<QGlyphRun> glyphRuns;
+        qreal ascent;
+    };
+
+    const ShapedText& shapeText(const QString& text) const;
+    QHash<int, ShapedLine> m_lines;
+    mutable QHash<QString, ShapedText> m_texts;
+    QFont m_font;
+    qreal m_underlinePosition;
+    qreal m_lineWidth;
+};
+
+#endif // LESSONTEXTENGINE_H
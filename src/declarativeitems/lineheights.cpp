@@ -0,0 +1,112 @@
+/*
+ *  Copyright 2026  The KTouch Developers <kde-edu@kde.org>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "lineheights.h"
+
+void LineHeights::reset(const QVector<qreal>& heights)
+{
+    const int count = heights.count();
+
+    m_heights = heights;
+    m_sums = QVector<qreal>(count + 1, 0);
+
+    // a binary indexed tree, m_sums[i] holds the heights of the lines (i - (i & -i), i]
+    for (int i = 1; i <= count; i++)
+    {
+        m_sums[i] += m_heights.at(i - 1);
+        const int parent = i + (i & -i);
+
+        if (parent <= count)
+        {
+            m_sums[parent] += m_sums.at(i);
+        }
+    }
+}
+
+int LineHeights::count() const
+{
+    return m_heights.count();
+}
+
+qreal LineHeights::height(int line) const
+{
+    return m_heights.at(line);
+}
+
+void LineHeights::setHeight(int line, qreal height)
+{
+    const qreal delta = height - m_heights.at(line);
+
+    if (delta == 0)
+        return;
+
+    m_heights[line] = height;
+
+    for (int i = line + 1; i < m_sums.count(); i += i & -i)
+    {
+        m_sums[i] += delta;
+    }
+}
+
+qreal LineHeights::top(int line) const
+{
+    qreal sum = 0;
+
+    for (int i = qMin(line, count()); i > 0; i -= i & -i)
+    {
+        sum += m_sums.at(i);
+    }
+
+    return sum;
+}
+
+qreal LineHeights::total() const
+{
+    return top(count());
+}
+
+int LineHeights::lineAt(qreal y) const
+{
+    const int count = this->count();
+
+    if (count == 0)
+        return 0;
+
+    int step = 1;
+
+    while (step * 2 <= count)
+    {
+        step *= 2;
+    }
+
+    // descend the tree to the number of lines that end at or above y
+    int line = 0;
+    qreal sum = 0;
+
+    for (; step > 0; step /= 2)
+    {
+        const int next = line + step;
+
+        if (next <= count && sum + m_sums.at(next) <= y)
+        {
+            line = next;
+            sum += m_sums.at(next);
+        }
+    }
+
+    return qMin(line, count - 1);
+}
@@ -0,0 +1,41 @@
+/*
+ *  Copyright 2026  The KTouch Developers <kde-edu@kde.org>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LINEHEIGHTS_H
+#define LINEHEIGHTS_H
+
+#include <QVector>
+
+// the heights of the lines of a lesson with their running sums, so a single
+// height can be changed and a position looked up without visiting every line
+class LineHeights
+{
+public:
+    void reset(const QVector<qreal>& heights);
+    int count() const;
+    qreal height(int line) const;
+    void setHeight(int line, qreal height);
+    qreal top(int line) const;
+    qreal total() const;
+    int lineAt(qreal y) const;
+
+private:
+    QVector<qreal> m_heights;
+    QVector<qreal> m_sums;
+};
+
+#endif // LINEHEIGHTS_H
@@ -46,6 +46,26 @@ void PreferencesProxy::setShowStatistics(bool showStatistics)
     Preferences::setShowStatistics(showStatistics);
 }
 
+bool PreferencesProxy::showErrorHeatmap() const
+{
+    return Preferences::showErrorHeatmap();
+}
+
+void PreferencesProxy::setShowErrorHeatmap(bool showErrorHeatmap)
+{
+    Preferences::setShowErrorHeatmap(showErrorHeatmap);
+}
+
+bool PreferencesProxy::sceneGraphLessonRendering() const
+{
+    return Preferences::sceneGraphLessonRendering();
+}
+
+void PreferencesProxy::setSceneGraphLessonRendering(bool sceneGraphLessonRendering)
+{
+    Preferences::setSceneGraphLessonRendering(sceneGraphLessonRendering);
+}
+
 bool PreferencesProxy::nextLineWithSpace() const
 {
     return Preferences::nextLineWithSpace();
@@ -27,6 +27,8 @@ class PreferencesProxy : public QObject
     Q_OBJECT
     Q_PROPERTY(bool showKeyboard READ showKeyboard WRITE setShowKeyboard NOTIFY configChanged)
     Q_PROPERTY(bool showStatistics READ showStatistics WRITE setShowStatistics NOTIFY configChanged)
+    Q_PROPERTY(bool showErrorHeatmap READ showErrorHeatmap WRITE setShowErrorHeatmap NOTIFY configChanged)
+    Q_PROPERTY(bool sceneGraphLessonRendering READ sceneGraphLessonRendering WRITE setSceneGraphLessonRendering NOTIFY configChanged)
     Q_PROPERTY(bool nextLineWithSpace READ nextLineWithSpace WRITE setNextLineWithSpace NOTIFY configChanged)
     Q_PROPERTY(bool nextLineWithReturn READ nextLineWithReturn WRITE setNextLineWithReturn NOTIFY configChanged)
     Q_PROPERTY(int requiredStrokesPerMinute READ requiredStrokesPerMinute WRITE setRequiredStrokesPerMinute NOTIFY configChanged)
@@ -39,6 +41,10 @@ public:
     void setShowKeyboard(bool showKeyboard);
     bool showStatistics() const;
     void setShowStatistics(bool showStatistics);
+    bool showErrorHeatmap() const;
+    void setShowErrorHeatmap(bool showErrorHeatmap);
+    bool sceneGraphLessonRendering() const;
+    void setSceneGraphLessonRendering(bool sceneGraphLessonRendering);
     bool nextLineWithSpace() const;
     void setNextLineWithSpace(bool nextLineWithSpace);
     bool nextLineWithReturn() const;
@@ -20,17 +20,37 @@
 #include <QKeyEvent>
 #include <QTextBoundaryFinder>
 
+#include "bindings/latencymonitor.h"
 #include "core/trainingstats.h"
 #include "preferences.h"
+#include "replay/sessionrecorder.h"
+
+static uint codePointAt(const QString& text, int position)
+{
+    const bool surrogatePair = position + 1 < text.length() && text.at(position).isHighSurrogate() && text.at(position + 1).isLowSurrogate();
+    return surrogatePair? QChar::surrogateToUcs4(text.at(position), text.at(position + 1)): text.at(position).unicode();
+}
 
 TrainingLineCore::TrainingLineCore(QQuickItem* parent) :
     QQuickItem(parent),
     m_active(false),
+    m_enforceErrorCorrection(true),
+    m_nextLineKey(0),
     m_trainingStats(0),
+    m_firstErrorPosition(-1),
     m_hintKey(-1),
-    m_keyHintOccurrenceCount(0)
+    m_keyHintOccurrenceCount(0),
+    m_dirtyStart(-1),
+    m_dirtyEnd(-1),
+    m_hintKeyDirty(false),
+    m_inputBatchOpen(false)
 {
     setFlag(QQuickItem::ItemAcceptsInputMethod, true);
+
+    updateInputPolicy();
+
+    connect(Preferences::self(), &KCoreConfigSkeleton::configChanged, this, &TrainingLineCore::updateInputPolicy);
+    connect(this, &TrainingLineCore::actualLineChanged, LatencyMonitor::self(), &LatencyMonitor::markLineChanged);
 }
 
 bool TrainingLineCore::active() const
@@ -70,7 +90,9 @@ void TrainingLineCore::setTrainingStats(TrainingStats* trainingStats)
 {
     if (trainingStats != m_trainingStats)
     {
+        endInputBatch();
         m_trainingStats = trainingStats;
+        SessionRecorder::self()->attachTrainingStats(m_trainingStats);
         emit trainingStatsChanged();
     }
 }
@@ -86,8 +108,13 @@ void TrainingLineCore::setReferenceLine(const QString& referenceLine)
     {
         m_referenceLine = referenceLine;
         m_actualLine = QLatin1String("");
+        m_firstErrorPosition = -1;
+        updateInputPolicy();
+        updateBoundaryTables();
+        discardChanges();
         clearKeyHint();
         emit referenceLineChanged();
+        emit actualLineSpanChanged(0, m_referenceLine.length());
         emit actualLineChanged();
     }
 }
@@ -104,10 +131,10 @@ QString TrainingLineCore::preeditString() const
 
 bool TrainingLineCore::isCorrect() const
 {
-    if (!Preferences::enforceTypingErrorCorrection())
+    if (!m_enforceErrorCorrection)
         return true;
 
-    return m_actualLine == m_referenceLine.left(m_actualLine.length());
+    return m_firstErrorPosition == -1;
 }
 
 QString TrainingLineCore::nextCharacter() const
@@ -116,7 +143,8 @@ QString TrainingLineCore::nextCharacter() const
 
     if (actualLength < m_referenceLine.length())
     {
-        return m_referenceLine.at(actualLength);
+        const bool surrogatePair = m_referenceLine.at(actualLength).isHighSurrogate() && actualLength + 1 < m_referenceLine.length();
+        return m_referenceLine.mid(actualLength, surrogatePair? 2: 1);
     }
 
     return QString();
@@ -127,15 +155,100 @@ int TrainingLineCore::hintKey() const
     return m_keyHintOccurrenceCount >= 3? m_hintKey: -1;
 }
 
+int TrainingLineCore::graphemeClusterStart(int position) const
+{
+    if (position <= 0 || m_clusterStarts.isEmpty())
+        return 0;
+
+    return m_clusterStarts.at(qMin(position, m_clusterStarts.length() - 1));
+}
+
+int TrainingLineCore::graphemeClusterEnd(int position) const
+{
+    if (position < 0 || m_clusterEnds.isEmpty())
+        return 0;
+
+    return m_clusterEnds.at(qMin(position, m_clusterEnds.length() - 1));
+}
+
+void TrainingLineCore::prefetchReferenceLine(const QString& referenceLine)
+{
+    if (referenceLine == m_prefetchedLine)
+        return;
+
+    // the tables are swapped in by setReferenceLine() if the line matches
+    m_prefetchedLine = referenceLine;
+    computeBoundaryTables(m_prefetchedLine, m_prefetchedClusterStarts, m_prefetchedClusterEnds, m_prefetchedWordBoundaries);
+}
+
 void TrainingLineCore::reset()
 {
     m_referenceLine = QLatin1String("");
     m_actualLine = QLatin1String("");
+    m_firstErrorPosition = -1;
+    updateInputPolicy();
+    updateBoundaryTables();
+    discardChanges();
     clearKeyHint();
     emit referenceLineChanged();
+    emit actualLineSpanChanged(0, 0);
     emit actualLineChanged();
 }
 
+void TrainingLineCore::updateInputPolicy()
+{
+    // snapshot the settings consulted for every keystroke, KConfigSkeleton
+    // lookups are far too expensive for the input path
+    m_enforceErrorCorrection = Preferences::enforceTypingErrorCorrection();
+
+    if (Preferences::nextLineWithReturn())
+    {
+        m_nextLineKey = Qt::Key_Return;
+    }
+    else if (Preferences::nextLineWithSpace())
+    {
+        m_nextLineKey = Qt::Key_Space;
+    }
+    else
+    {
+        m_nextLineKey = 0;
+    }
+}
+
+bool TrainingLineCore::event(QEvent* event)
+{
+    if (!m_trainingStats || (event->type() != QEvent::KeyPress && event->type() != QEvent::InputMethod))
+        return QQuickItem::event(event);
+
+    // the Keys attached handlers run from QQuickItem::event(), so the clock is
+    // latched before they can start the training
+    const bool latched = m_trainingStats->latchClock();
+
+    if (m_active)
+    {
+        SessionRecorder::self()->recordEvent(event, m_trainingStats->clockNSecs());
+        beginInputBatch();
+    }
+
+    const bool result = QQuickItem::event(event);
+
+    // the stats announce the changes of the event once it is fully handled
+    endInputBatch();
+
+    if (m_dirtyStart == -1)
+    {
+        // keys which left the line alone must not start a latency sample
+        LatencyMonitor::self()->discardInput();
+    }
+
+    if (latched)
+    {
+        m_trainingStats->releaseClock();
+    }
+
+    return result;
+}
+
 void TrainingLineCore::keyPressEvent(QKeyEvent* event)
 {
     QQuickItem::keyPressEvent(event);
@@ -146,12 +259,15 @@ void TrainingLineCore::keyPressEvent(QKeyEvent* event)
         return;
     }
 
+    LatencyMonitor::self()->markInput();
+
     if (isCorrect() && m_referenceLine.length() == m_actualLine.length())
     {
-        if (Preferences::nextLineWithReturn())
+        if (m_nextLineKey != 0)
         {
-            if (event->key() == Qt::Key_Return)
+            if (event->key() == m_nextLineKey)
             {
+                flushChanges();
                 emit done();
                 clearActualLine();
                 clearKeyHint();
@@ -160,22 +276,7 @@ void TrainingLineCore::keyPressEvent(QKeyEvent* event)
             }
             else
             {
-                giveKeyHint(Qt::Key_Return);
-            }
-        }
-        else if (Preferences::nextLineWithSpace())
-        {
-            if (event->key() == Qt::Key_Space)
-            {
-                emit done();
-                clearActualLine();
-                clearKeyHint();
-                event->accept();
-                return;
-            }
-            else
-            {
-                giveKeyHint(Qt::Key_Space);
+                giveKeyHint(m_nextLineKey);
             }
         }
     }
@@ -237,6 +338,8 @@ void TrainingLineCore::inputMethodEvent(QInputMethodEvent *event)
         return;
     }
 
+    LatencyMonitor::self()->markInput();
+
     const QString commitString = event->commitString();
     const QString preeditString = event->preeditString();
 
@@ -277,49 +380,105 @@ QVariant TrainingLineCore::inputMethodQuery(Qt::InputMethodQuery query) const
     }
 }
 
+void TrainingLineCore::updatePolish()
+{
+    QQuickItem::updatePolish();
+
+    // all changes made since the last frame are announced at once
+    flushChanges();
+}
+
 void TrainingLineCore::add(const QString& text)
 {
-    const int maxLength = m_referenceLine.length();
+    const QStringRef newText = text.leftRef(m_referenceLine.length() - m_actualLine.length());
+
+    if (m_enforceErrorCorrection)
+    {
+        addText<true>(newText);
+    }
+    else
+    {
+        addText<false>(newText);
+    }
+}
+
+template<bool enforceErrorCorrection>
+void TrainingLineCore::addText(const QStringRef& newText)
+{
     const int actualLength = m_actualLine.length();
+    const int newLength = actualLength + newText.length();
 
-    const QString newText = text.left(maxLength - actualLength);
-    bool correct = isCorrect();
+    bool correct = !enforceErrorCorrection || m_firstErrorPosition == -1;
 
-    for (int i = 0; i < newText.length(); i++)
+    m_actualLine += newText;
+
+    // the new text is judged one grapheme cluster of the reference line at a
+    // time, so surrogate pairs and combining sequences are right or wrong as a whole
+    int position = actualLength;
+
+    while (position < newLength)
     {
-        const QString character(newText.at(i));
-        const QString referenceCharacter(m_referenceLine.at(actualLength + i));
-        const bool characterIsCorrect = character == referenceCharacter;
+        const int clusterStart = m_clusterStarts.at(position);
+        const int clusterEnd = m_clusterEnds.at(position);
+        const int end = qMin(clusterEnd, newLength);
+        const bool clusterIsCorrect = m_actualLine.midRef(clusterStart, end - clusterStart) == m_referenceLine.midRef(clusterStart, end - clusterStart);
 
-        if (m_trainingStats)
+        if (!clusterIsCorrect && m_firstErrorPosition == -1)
         {
-            m_trainingStats->logCharacter(referenceCharacter, characterIsCorrect? TrainingStats::CorrectCharacter: TrainingStats::IncorrectCharacter);
+            m_firstErrorPosition = mismatchPosition(clusterStart, end);
         }
 
-        correct = correct && (!Preferences::enforceTypingErrorCorrection() || characterIsCorrect);
-
-        if (correct)
+        // a cluster committed over several events is counted once it is complete
+        if (m_trainingStats && end == clusterEnd)
         {
-            clearKeyHint();
+            m_trainingStats->logCharacter(codePointAt(m_referenceLine, clusterStart), codePointAt(m_actualLine, clusterStart), clusterIsCorrect? TrainingStats::CorrectCharacter: TrainingStats::IncorrectCharacter);
         }
-        else
+
+        if (enforceErrorCorrection)
         {
-            giveKeyHint(Qt::Key_Backspace);
+            correct = correct && clusterIsCorrect;
+
+            if (correct)
+            {
+                clearKeyHint();
+            }
+            else
+            {
+                giveKeyHint(Qt::Key_Backspace);
+            }
         }
+
+        position = end;
     }
 
-    m_actualLine += text.leftRef(maxLength - actualLength);
-    emit actualLineChanged();
+    if (!enforceErrorCorrection && !newText.isEmpty())
+    {
+        clearKeyHint();
+    }
+
+    markActualLineDirty(actualLength, newLength);
 }
 
 void TrainingLineCore::backspace()
 {
     const int actualLength = m_actualLine.length();
 
-    if (actualLength > 0 && Preferences::enforceTypingErrorCorrection())
+    if (actualLength > 0 && m_enforceErrorCorrection)
     {
-        m_actualLine = m_actualLine.left(actualLength - 1);
-        emit actualLineChanged();
+        int length;
+
+        if (m_firstErrorPosition == -1)
+        {
+            // the actual line is a prefix of the reference line, remove the whole cluster
+            length = m_clusterStarts.at(actualLength - 1);
+        }
+        else
+        {
+            const bool surrogatePair = actualLength > 1 && m_actualLine.at(actualLength - 1).isLowSurrogate() && m_actualLine.at(actualLength - 2).isHighSurrogate();
+            length = actualLength - (surrogatePair? 2: 1);
+        }
+
+        truncateActualLine(length);
 
         if (isCorrect())
         {
@@ -332,22 +491,122 @@ void TrainingLineCore::deleteStartOfWord()
 {
     const int actualLength = m_actualLine.length();
 
-    if (actualLength > 0 && Preferences::enforceTypingErrorCorrection())
+    if (actualLength > 0 && m_enforceErrorCorrection)
     {
+        // the boundaries of the reference line hold for the actual line only if it
+        // is a prefix ending at a word boundary, within a word the missing rest of
+        // the word may change them
+        const bool atWordBoundary = actualLength == m_referenceLine.length() || m_previousWordBoundaries.at(actualLength + 1) == actualLength;
+
+        if (m_firstErrorPosition == -1 && atWordBoundary)
+        {
+            truncateActualLine(m_previousWordBoundaries.at(actualLength));
+            return;
+        }
+
         QTextBoundaryFinder finder(QTextBoundaryFinder::Word, m_actualLine);
 
         finder.setPosition(actualLength);
         finder.toPreviousBoundary();
 
-        m_actualLine = m_actualLine.left(finder.position());
-        emit actualLineChanged();
+        truncateActualLine(finder.position());
     }
 }
 
 void TrainingLineCore::clearActualLine()
 {
-    m_actualLine = QLatin1String("");
-    emit actualLineChanged();
+    truncateActualLine(0);
+}
+
+void TrainingLineCore::truncateActualLine(int length)
+{
+    markActualLineDirty(length, m_actualLine.length());
+    m_actualLine.truncate(length);
+
+    if (m_firstErrorPosition >= length)
+    {
+        m_firstErrorPosition = -1;
+    }
+}
+
+int TrainingLineCore::mismatchPosition(int start, int end) const
+{
+    // the error is recorded at the first wrong code point rather than at the
+    // start of its cluster, so removing it restores a correct partial cluster
+    int position = start;
+
+    while (position < end && m_actualLine.at(position) == m_referenceLine.at(position))
+    {
+        position++;
+    }
+
+    if (position > start && m_actualLine.at(position - 1).isHighSurrogate())
+    {
+        position--;
+    }
+
+    return position;
+}
+
+void TrainingLineCore::updateBoundaryTables()
+{
+    if (!m_prefetchedLine.isNull() && m_referenceLine == m_prefetchedLine)
+    {
+        m_clusterStarts.swap(m_prefetchedClusterStarts);
+        m_clusterEnds.swap(m_prefetchedClusterEnds);
+        m_previousWordBoundaries.swap(m_prefetchedWordBoundaries);
+        m_prefetchedLine = QString();
+        return;
+    }
+
+    computeBoundaryTables(m_referenceLine, m_clusterStarts, m_clusterEnds, m_previousWordBoundaries);
+}
+
+void TrainingLineCore::computeBoundaryTables(const QString& line, QVector<int>& clusterStarts, QVector<int>& clusterEnds, QVector<int>& previousWordBoundaries)
+{
+    const int length = line.length();
+
+    clusterStarts.resize(length);
+    clusterEnds.resize(length);
+    previousWordBoundaries.resize(length + 1);
+
+    QTextBoundaryFinder graphemeFinder(QTextBoundaryFinder::Grapheme, line);
+    int clusterStart = 0;
+
+    while (clusterStart < length)
+    {
+        graphemeFinder.setPosition(clusterStart);
+        int clusterEnd = graphemeFinder.toNextBoundary();
+
+        if (clusterEnd <= clusterStart)
+            clusterEnd = length;
+
+        for (int i = clusterStart; i < clusterEnd; i++)
+        {
+            clusterStarts[i] = clusterStart;
+            clusterEnds[i] = clusterEnd;
+        }
+
+        clusterStart = clusterEnd;
+    }
+
+    // for each position the boundary QTextBoundaryFinder::toPreviousBoundary() would find
+    QTextBoundaryFinder wordFinder(QTextBoundaryFinder::Word, line);
+    int previousBoundary = 0;
+    int nextBoundary = wordFinder.toNextBoundary();
+
+    previousWordBoundaries[0] = 0;
+
+    for (int position = 1; position <= length; position++)
+    {
+        while (nextBoundary != -1 && nextBoundary < position)
+        {
+            previousBoundary = nextBoundary;
+            nextBoundary = wordFinder.toNextBoundary();
+        }
+
+        previousWordBoundaries[position] = previousBoundary;
+    }
 }
 
 void TrainingLineCore::giveKeyHint(int key)
@@ -362,7 +621,7 @@ void TrainingLineCore::giveKeyHint(int key)
         m_keyHintOccurrenceCount = 1;
     }
 
-    emit hintKeyChanged();
+    markHintKeyDirty();
 }
 
 void TrainingLineCore::clearKeyHint()
@@ -370,5 +629,71 @@ void TrainingLineCore::clearKeyHint()
     m_hintKey = -1;
     m_keyHintOccurrenceCount = 0;
 
-    emit hintKeyChanged();
+    markHintKeyDirty();
+}
+
+void TrainingLineCore::markActualLineDirty(int start, int end)
+{
+    m_dirtyStart = m_dirtyStart == -1? start: qMin(m_dirtyStart, start);
+    m_dirtyEnd = qMax(m_dirtyEnd, end);
+
+    // ### without a window there is no frame to wait for
+    if (window())
+        polish();
+    else
+        flushChanges();
+}
+
+void TrainingLineCore::markHintKeyDirty()
+{
+    m_hintKeyDirty = true;
+
+    if (window())
+        polish();
+    else
+        flushChanges();
+}
+
+void TrainingLineCore::beginInputBatch()
+{
+    if (m_inputBatchOpen)
+        return;
+
+    // all characters of an event, such as an input method commit, are logged
+    // first and announced by the stats together
+    m_trainingStats->beginBatch();
+    m_inputBatchOpen = true;
+}
+
+void TrainingLineCore::endInputBatch()
+{
+    if (!m_inputBatchOpen)
+        return;
+
+    m_inputBatchOpen = false;
+    m_trainingStats->endBatch();
+}
+
+void TrainingLineCore::discardChanges()
+{
+    m_dirtyStart = -1;
+    m_dirtyEnd = -1;
+}
+
+void TrainingLineCore::flushChanges()
+{
+    if (m_dirtyStart != -1)
+    {
+        const int start = m_dirtyStart;
+        const int end = m_dirtyEnd;
+        discardChanges();
+        emit actualLineSpanChanged(start, end);
+        emit actualLineChanged();
+    }
+
+    if (m_hintKeyDirty)
+    {
+        m_hintKeyDirty = false;
+        emit hintKeyChanged();
+    }
 }
@@ -21,6 +21,7 @@
 #include <QQuickItem>
 
 #include <QPointer>
+#include <QVector>
 
 class TrainingStats;
 
@@ -51,8 +52,13 @@ public:
     bool isCorrect() const;
     QString nextCharacter() const;
     int hintKey() const;
+    int graphemeClusterStart(int position) const;
+    int graphemeClusterEnd(int position) const;
+    void prefetchReferenceLine(const QString& referenceLine);
+    static void computeBoundaryTables(const QString& line, QVector<int>& clusterStarts, QVector<int>& clusterEnds, QVector<int>& previousWordBoundaries);
 public slots:
     void reset();
+    void updateInputPolicy();
 signals:
     void activeChanged();
     void cursorItemChanged();
@@ -61,25 +67,52 @@ signals:
     void actualLineChanged();
     void preeditStringChanged();
     void hintKeyChanged();
+    void actualLineSpanChanged(int start, int end);
     void done();
 protected:
+    bool event(QEvent* event) override;
     void keyPressEvent(QKeyEvent* event) override;
     void inputMethodEvent(QInputMethodEvent* event) override;
     QVariant inputMethodQuery(Qt::InputMethodQuery query) const override;
+    void updatePolish() override;
 private:
     void add(const QString& text);
+    template<bool enforceErrorCorrection> void addText(const QStringRef& newText);
     void backspace();
     void deleteStartOfWord();
     void clearActualLine();
+    void truncateActualLine(int length);
+    int mismatchPosition(int start, int end) const;
+    void updateBoundaryTables();
     void giveKeyHint(int key);
     void clearKeyHint();
+    void markActualLineDirty(int start, int end);
+    void markHintKeyDirty();
+    void beginInputBatch();
+    void endInputBatch();
+    void discardChanges();
+    void flushChanges();
     bool m_active;
+    bool m_enforceErrorCorrection;
+    int m_nextLineKey;
     TrainingStats* m_trainingStats;
     QString m_referenceLine;
     QString m_actualLine;
+    int m_firstErrorPosition;
+    QVector<int> m_clusterStarts;
+    QVector<int> m_clusterEnds;
+    QVector<int> m_previousWordBoundaries;
+    QString m_prefetchedLine;
+    QVector<int> m_prefetchedClusterStarts;
+    QVector<int> m_prefetchedClusterEnds;
+    QVector<int> m_prefetchedWordBoundaries;
     QString m_preeditString;
     int m_hintKey;
     int m_keyHintOccurrenceCount;
+    int m_dirtyStart;
+    int m_dirtyEnd;
+    bool m_hintKeyDirty;
+    bool m_inputBatchOpen;
     QPointer<QQuickItem> m_cursorItem;
 };
 
@@ -16,12 +16,17 @@
  */
 
 #include <QCommandLineParser>
+#include <QTextStream>
 
 #include <KAboutData>
 #include <KLocalizedString>
 
 #include "application.h"
+#include "bindings/latencymonitor.h"
 #include "mainwindow.h"
+#include "replay/replayengine.h"
+#include "replay/sessionplayer.h"
+#include "replay/sessionrecorder.h"
 #include "version.h"
 
 int main(int argc, char **argv)
@@ -73,6 +78,19 @@ int main(int argc, char **argv)
 
     parser.addOption({{"I", "import-path"}, i18n("Prepend the path to the list of QML import paths"), QStringLiteral("path")});
 
+    parser.addOption(QCommandLineOption(QStringLiteral("latency-log"), i18n("Measure the typing latency of training sessions and append the results to the file"), QStringLiteral("file")));
+
+    parser.addOption(QCommandLineOption(QStringLiteral("replay"), i18n("Replay synthetic keystrokes against every lesson of the course file or course directory without showing a window and print the timings"), QStringLiteral("path")));
+
+    parser.addOption(QCommandLineOption(QStringLiteral("replay-line-lengths"), i18n("Replay synthetic keystrokes against single lines of growing length without showing a window and print the timings")));
+
+
+    parser.addOption(QCommandLineOption(QStringLiteral("replay-rate"), i18n("Replay speed relative to real time, 0 replays as fast as possible"), QStringLiteral("factor"), QStringLiteral("0")));
+
+    parser.addOption(QCommandLineOption(QStringLiteral("record-sessions"), i18n("Append a compact recording of every training session to the file"), QStringLiteral("file")));
+
+    parser.addOption(QCommandLineOption(QStringLiteral("play-sessions"), i18n("Play back the recorded sessions of the file against the lessons given with --replay and print their statistics"), QStringLiteral("file")));
+
     parser.process(app);
 
     about.processCommandLine(&parser);
@@ -86,6 +104,36 @@ int main(int argc, char **argv)
     }
 
 
+    if (parser.isSet(QStringLiteral("latency-log")))
+    {
+        LatencyMonitor::self()->setLogFile(parser.value(QStringLiteral("latency-log")));
+        LatencyMonitor::self()->setEnabled(true);
+    }
+
+    if (parser.isSet(QStringLiteral("record-sessions")))
+    {
+        SessionRecorder::self()->setLogFile(parser.value(QStringLiteral("record-sessions")));
+    }
+
+    if (parser.isSet(QStringLiteral("play-sessions")))
+    {
+        QTextStream out(stdout);
+        return SessionPlayer::playFile(parser.value(QStringLiteral("play-sessions")), parser.value(QStringLiteral("replay")), out)? 0: 1;
+    }
+
+    if (parser.isSet(QStringLiteral("replay-line-lengths")))
+    {
+        QTextStream out(stdout);
+        return ReplayEngine::runLineLengthBenchmark(out)? 0: 1;
+    }
+
+    if (parser.isSet(QStringLiteral("replay")))
+    {
+        QTextStream out(stdout);
+        const qreal rate = parser.value(QStringLiteral("replay-rate")).toDouble();
+        return ReplayEngine::runBenchmark(parser.value(QStringLiteral("replay")), rate, out)? 0: 1;
+    }
+
     if (app.isSessionRestored())
     {
         for (int i = 1; KMainWindow::canBeRestored(i); i++)
@@ -17,6 +17,8 @@
 
 #include "errorsmodel.h"
 
+#include <QStringList>
+
 #include "core/trainingstats.h"
 
 bool lessThan(const QPair<QString,int>& left, const QPair<QString,int>& right)
@@ -98,7 +100,7 @@ int ErrorsModel::rowCount(const QModelIndex& parent) const
     if (!m_trainingStats)
         return 0;
 
-    return m_trainingStats->errorMap().count();
+    return m_errors.count();
 }
 
 QVariant ErrorsModel::headerData(int section, Qt::Orientation orientation, int role) const
@@ -130,12 +132,11 @@ void ErrorsModel::buildErrorList()
         return;
     }
 
-    QMapIterator<QString, int> errorIterator(m_trainingStats->errorMap());
+    const auto errorCounts = m_trainingStats->confusionMatrix().errorCounts();
 
-    while(errorIterator.hasNext())
+    for (const auto& errorCount: errorCounts)
     {
-        errorIterator.next();
-        m_errors.append(QPair<QString,int>(errorIterator.key(), errorIterator.value()));
+        m_errors.append(QPair<QString,int>(ConfusionMatrix::character(errorCount.first), errorCount.second));
     }
 
     std::sort(m_errors.begin(), m_errors.end(), lessThan);
@@ -154,3 +155,33 @@ int ErrorsModel::errors(int row) const
 {
     return m_errors.at(row).second;
 }
+
+QString ErrorsModel::typedInstead(int row) const
+{
+    if (!m_trainingStats)
+        return QString();
+
+    const uint expected = ConfusionMatrix::codePoint(m_errors.at(row).first);
+    QVector<ConfusionMatrix::Cell> cells;
+
+    foreach (const ConfusionMatrix::Cell& cell, m_trainingStats->confusionMatrix().cells())
+    {
+        if (cell.expected == expected && cell.typed != 0)
+        {
+            cells.append(cell);
+        }
+    }
+
+    std::sort(cells.begin(), cells.end(), [](const ConfusionMatrix::Cell& left, const ConfusionMatrix::Cell& right) {
+        return left.count > right.count;
+    });
+
+    QStringList result;
+
+    foreach (const ConfusionMatrix::Cell& cell, cells)
+    {
+        result << QStringLiteral("%1 (%2)").arg(ConfusionMatrix::character(cell.typed)).arg(cell.count);
+    }
+
+    return result.join(QStringLiteral(", "));
+}
@@ -38,6 +38,7 @@ public:
     QVariant headerData(int section, Qt::Orientation orientation, int role) const override;
     Q_INVOKABLE QString character(int row) const;
     Q_INVOKABLE int errors(int row) const;
+    Q_INVOKABLE QString typedInstead(int row) const;
 signals:
     void trainingStatsChanged();
     void maximumErrorCountChanged();
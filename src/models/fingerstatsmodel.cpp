@@ -0,0 +1,182 @@
+/*
+ *  Copyright 2026  The KTouch Developers <kde-edu@kde.org>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "fingerstatsmodel.h"
+
+#include <KLocalizedString>
+
+#include "core/trainingstats.h"
+
+FingerStatsModel::FingerStatsModel(QObject* parent) :
+    QAbstractTableModel(parent),
+    m_trainingStats(0)
+{
+}
+
+TrainingStats* FingerStatsModel::trainingStats() const
+{
+    return m_trainingStats;
+}
+
+void FingerStatsModel::setTrainingStats(TrainingStats* trainingStats)
+{
+    if (trainingStats != m_trainingStats)
+    {
+        if (m_trainingStats)
+        {
+            m_trainingStats->disconnect(this);
+        }
+
+        m_trainingStats = trainingStats;
+
+        if (m_trainingStats)
+        {
+            connect(m_trainingStats, &TrainingStats::keystrokesChanged, this, &FingerStatsModel::buildFingerList);
+        }
+
+        buildFingerList();
+        emit trainingStatsChanged();
+    }
+}
+
+double FingerStatsModel::maximumErrorRate() const
+{
+    double result = 0.0;
+
+    foreach (int finger, m_fingers)
+    {
+        result = qMax(result, m_trainingStats->fingerStats().at(finger).errorRate());
+    }
+
+    return result;
+}
+
+QVariant FingerStatsModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid())
+        return QVariant();
+
+    if (index.row() >= m_fingers.count())
+        return QVariant();
+
+    switch(role)
+    {
+    case Qt::DisplayRole:
+        return QVariant(100.0 * m_trainingStats->fingerStats().at(m_fingers.at(index.row())).errorRate());
+    case Qt::ToolTipRole:
+        return QVariant(fingerName(index.row()));
+    default:
+        return QVariant();
+    }
+}
+
+int FingerStatsModel::columnCount(const QModelIndex& parent) const
+{
+    Q_UNUSED(parent)
+
+    return 1;
+}
+
+int FingerStatsModel::rowCount(const QModelIndex& parent) const
+{
+    if (parent.isValid())
+        return 0;
+
+    if (!m_trainingStats)
+        return 0;
+
+    return m_fingers.count();
+}
+
+QVariant FingerStatsModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole)
+        return QVariant();
+
+    if (orientation == Qt::Vertical)
+        return QAbstractTableModel::headerData(section, orientation, role);
+
+    switch (section)
+    {
+    case 0:
+        return QVariant("errorRate");
+    default:
+        return QVariant();
+    }
+}
+
+void FingerStatsModel::buildFingerList()
+{
+    beginResetModel();
+
+    m_fingers.clear();
+
+    if (m_trainingStats)
+    {
+        for (int finger = 0; finger < FingerStats::FingerCount; finger++)
+        {
+            if (m_trainingStats->fingerStats().at(finger).keystrokes > 0)
+            {
+                m_fingers.append(finger);
+            }
+        }
+    }
+
+    emit maximumErrorRateChanged();
+
+    endResetModel();
+}
+
+QString FingerStatsModel::fingerName(int row) const
+{
+    switch (m_fingers.at(row))
+    {
+    case 0:
+        return i18n("Left little finger");
+    case 1:
+        return i18n("Left ring finger");
+    case 2:
+        return i18n("Left middle finger");
+    case 3:
+        return i18n("Left index finger");
+    case 4:
+        return i18n("Right index finger");
+    case 5:
+        return i18n("Right middle finger");
+    case 6:
+        return i18n("Right ring finger");
+    case 7:
+        return i18n("Right little finger");
+    default:
+        return QString();
+    }
+}
+
+int FingerStatsModel::keystrokes(int row) const
+{
+    return m_trainingStats->fingerStats().at(m_fingers.at(row)).keystrokes;
+}
+
+int FingerStatsModel::errors(int row) const
+{
+    return m_trainingStats->fingerStats().at(m_fingers.at(row)).errors;
+}
+
+double FingerStatsModel::meanInterval(int row) const
+{
+    return m_trainingStats->fingerStats().at(m_fingers.at(row)).meanInterval;
+}
@@ -0,0 +1,53 @@
+/*
+ *  Copyright 2026  The KTouch Developers <kde-edu@kde.org>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef FINGERSTATSMODEL_H
+#define FINGERSTATSMODEL_H
+
+#include <QAbstractTableModel>
+
+class TrainingStats;
+
+class FingerStatsModel : public QAbstractTableModel
+{
+    Q_OBJECT
+    Q_PROPERTY(TrainingStats* trainingStats READ trainingStats WRITE setTrainingStats NOTIFY trainingStatsChanged)
+    Q_PROPERTY(double maximumErrorRate READ maximumErrorRate NOTIFY maximumErrorRateChanged)
+public:
+    explicit FingerStatsModel(QObject* parent = nullptr);
+    TrainingStats* trainingStats() const;
+    void setTrainingStats(TrainingStats* trainingStats);
+    double maximumErrorRate() const;
+    QVariant data(const QModelIndex& index, int role) const override;
+    int columnCount(const QModelIndex& parent) const override;
+    int rowCount(const QModelIndex& parent) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role) const override;
+    Q_INVOKABLE QString fingerName(int row) const;
+    Q_INVOKABLE int keystrokes(int row) const;
+    Q_INVOKABLE int errors(int row) const;
+    Q_INVOKABLE double meanInterval(int row) const;
+signals:
+    void trainingStatsChanged();
+    void maximumErrorRateChanged();
+private slots:
+    void buildFingerList();
+private:
+    TrainingStats* m_trainingStats;
+    QList<int> m_fingers;
+};
+
+#endif // FINGERSTATSMODEL_H
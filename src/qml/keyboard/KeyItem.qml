@@ -34,46 +34,7 @@ Item {
 
     property AbstractKey key: item.keyboardLayout.key(item.keyIndex)
     property AbstractKey referenceKey: keyboardLayout.referenceKey
-
-    function match(data) {
-        var eventText = data
-        var eventKey = -1
-        if (typeof data === "object") {
-            eventText = data.text
-            eventKey = data.key
-        }
-        if (typeof data === "number") {
-            eventText = ""
-            eventKey = data
-        }
-        switch (key.keyType()) {
-        case "key":
-            for (var i = 0; i < key.keyCharCount; i++) {
-                if (key.keyChar(i).value == eventText) {
-                    return true;
-                }
-            }
-            return false
-
-        case "specialKey":
-            switch (key.type) {
-            case SpecialKey.Tab:
-                return eventKey == Qt.Key_Tab
-            case SpecialKey.Capslock:
-                return eventKey == Qt.Key_CapsLock
-            case SpecialKey.Shift:
-                return eventKey == Qt.Key_Shift
-            case SpecialKey.Backspace:
-                return eventKey == Qt.Key_Backspace
-            case SpecialKey.Return:
-                return eventKey == Qt.Key_Return
-            case SpecialKey.Space:
-                return eventKey == Qt.Key_Space || eventText == " "
-            }
-            return false
-        }
-        return false;
-    }
+    property real errorIntensity: 0
 
     function getTint(color) {
         color.a = 0.125
@@ -212,6 +173,15 @@ Item {
             GradientStop { id: gradientStop2; position: 1.0; }
         }
 
+        Rectangle {
+            id: errorOverlay
+            anchors.fill: parent
+            radius: body.radius
+            color: "#ff0000"
+            opacity: 0.5 * item.errorIntensity
+            visible: opacity > 0
+        }
+
         Rectangle {
             id: hapticMarker
             anchors {
@@ -24,6 +24,7 @@ Item {
     signal keyboardUpdate
 
     property KeyboardLayout keyboardLayout
+    property ErrorHeatmap errorHeatmap: null
     property real aspectRatio: keyboardLayout.width / keyboardLayout.height
     property real horizontalScaleFactor: width / keyboardLayout.width
     property real verticalScaleFactor: height / keyboardLayout.height
@@ -38,25 +39,37 @@ Item {
         return items
     }
 
-    function findKeyItems(keyChar) {
-        var matchingKeys = []
-
-        for (var i = 0; i < keys.count; i++) {
-            var key = keys.itemAt(i);
-            if (key.match(keyChar))
-            matchingKeys.push(key)
+    function findKeyItems(data) {
+        var text = data
+        var qtKey = -1
+        if (typeof data === "object") {
+            text = data.text
+            qtKey = data.key
+        }
+        if (typeof data === "number") {
+            text = ""
+            qtKey = data
         }
 
-        return matchingKeys
+        return keyItemsAt(keyboardLayout.findKeys(text, qtKey))
     }
 
-    function findModifierKeyItem(modifierId) {
-        for (var i = 0; i < keys.count; i++) {
-            var key = keys.itemAt(i);
-            if (key.key.keyType() === "specialKey" && key.key.modifierId === modifierId)
-                return key
+    function findHighlightKeyItems(which) {
+        if (typeof which === "number")
+            return keyItemsAt(keyboardLayout.findHighlightKeys("", which))
+        return keyItemsAt(keyboardLayout.findHighlightKeys(which))
+    }
+
+    function keyItemsAt(indexes) {
+        var matchingKeys = []
+
+        for (var i = 0; i < indexes.length; i++) {
+            var key = keys.itemAt(indexes[i])
+            if (key)
+                matchingKeys.push(key)
         }
-        return null
+
+        return matchingKeys
     }
 
     function handleKeyPress(event) {
@@ -84,13 +97,15 @@ Item {
 
         Repeater {
             id: keys
-            model: keyboard.visible && keyboardLayout.isValid? keyboard.keyboardLayout.keyCount: 0
+            // the heatmap has a row per key and updates the intensity of single keys
+            model: keyboard.visible && keyboardLayout.isValid? (keyboard.errorHeatmap? keyboard.errorHeatmap: keyboard.keyboardLayout.keyCount): 0
 
             onModelChanged: keyboard.keyboardUpdate()
 
             KeyItem {
                 keyboardLayout: keyboard.keyboardLayout;
                 keyIndex: index
+                errorIntensity: keyboard.errorHeatmap? model.intensity: 0
                 horizontalScaleFactor: keyboard.horizontalScaleFactor
                 verticalScaleFactor: keyboard.verticalScaleFactor
             }
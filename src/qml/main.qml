@@ -67,6 +67,9 @@ Rectangle {
 
     ProfileDataAccess {
         id: profileDataAccess
+
+        // sessions interrupted by a crash are saved before anything reads the stats
+        Component.onCompleted: profileDataAccess.recoverTrainingStats()
     }
 
     Preferences {
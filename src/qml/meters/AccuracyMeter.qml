@@ -23,6 +23,7 @@ Meter {
     id: meter
 
     property real accuracy: 1.0
+    property real currentAccuracy: meter.accuracy
     property real referenceAccuracy: 1.0
 
     label: i18n("Accuracy")
@@ -80,7 +81,7 @@ Meter {
             transform: Rotation {
                 origin.x: hand.width / 2
                 origin.y: hand.height / 2
-                angle: Math.min(90, Math.max(0, accuracy - 0.9) * 900)
+                angle: Math.min(90, Math.max(0, currentAccuracy - 0.9) * 900)
                 Behavior on angle {
                     SpringAnimation { spring: 2; damping: 0.2; modulus: 360; mass: 0.75}
                 }
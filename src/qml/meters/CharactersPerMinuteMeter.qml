@@ -23,6 +23,7 @@ Meter {
     id: meter
 
     property int charactersPerMinute: 0
+    property int currentCharactersPerMinute: meter.charactersPerMinute
     property int referenceCharactersPerMinute: 0
 
     property int minimumCharactersPerMinute: preferences.requiredStrokesPerMinute
@@ -84,7 +85,7 @@ Meter {
             transform: Rotation {
                 origin.x: hand.width / 2
                 origin.y: hand.height / 2
-                angle: Math.min(90, charactersPerMinute * 90 / 360)
+                angle: Math.min(90, currentCharactersPerMinute * 90 / 360)
                 Behavior on angle {
                     SpringAnimation { spring: 2; damping: 0.2; modulus: 360; mass: 0.75}
                 }
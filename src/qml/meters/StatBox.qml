@@ -23,6 +23,7 @@ import ktouch 1.0
 RowLayout {
     property TrainingStats stats
     property TrainingStats referenceStats
+    property bool showRecentStats: false
 
     height: childrenRect.height
     spacing: 10
@@ -38,6 +39,7 @@ RowLayout {
         id: charactersPerMinuteMeter
         Layout.fillWidth: true
         charactersPerMinute: stats.charactersPerMinute
+        currentCharactersPerMinute: showRecentStats && stats.timeIsRunning? stats.recentCharactersPerMinute: stats.charactersPerMinute
         referenceCharactersPerMinute: referenceStats.isValid? referenceStats.charactersPerMinute: stats.charactersPerMinute
     }
 
@@ -45,6 +47,7 @@ RowLayout {
         id: accuracyMeter
         Layout.fillWidth: true
         accuracy: stats.accuracy
+        currentAccuracy: showRecentStats && stats.timeIsRunning? stats.recentAccuracy: stats.accuracy
         referenceAccuracy: referenceStats.isValid? referenceStats.accuracy: stats.accuracy
     }
 }
@@ -121,6 +121,11 @@ FocusScope {
         trainingStats: screen.visible? screen.stats: null
     }
 
+    FingerStatsModel {
+        id: fingerStatsModel
+        trainingStats: screen.visible? screen.stats: null
+    }
+
     Balloon {
         id: errorsTooltip
         visualParent: parent
@@ -135,6 +140,39 @@ FocusScope {
                 InfoItem {
                     title: i18n("Errors:")
                     text: errorsTooltip.row !== -1? errorsModel.errors(errorsTooltip.row): ""
+                },
+                InfoItem {
+                    title: i18n("Typed instead:")
+                    text: errorsTooltip.row !== -1? errorsModel.typedInstead(errorsTooltip.row): ""
+                }
+            ]
+            width: 250
+            model: infoModel
+        }
+    }
+
+    Balloon {
+        id: fingerStatsTooltip
+        visualParent: parent
+        property int row: -1
+
+        InformationTable {
+            property list<InfoItem> infoModel: [
+                InfoItem {
+                    title: i18n("Finger:")
+                    text: fingerStatsTooltip.row !== -1? fingerStatsModel.fingerName(fingerStatsTooltip.row): ""
+                },
+                InfoItem {
+                    title: i18n("Keystrokes:")
+                    text: fingerStatsTooltip.row !== -1? fingerStatsModel.keystrokes(fingerStatsTooltip.row): ""
+                },
+                InfoItem {
+                    title: i18n("Errors:")
+                    text: fingerStatsTooltip.row !== -1? fingerStatsModel.errors(fingerStatsTooltip.row): ""
+                },
+                InfoItem {
+                    title: i18n("Average time between keystrokes:")
+                    text: fingerStatsTooltip.row !== -1? i18n("%1 ms", Math.round(fingerStatsModel.meanInterval(fingerStatsTooltip.row))): ""
                 }
             ]
             width: 250
@@ -295,6 +333,7 @@ FocusScope {
                             Component.onCompleted: {
                                 append({"text": i18n("Progress"), "icon": "office-chart-area"});
                                 append({"text": i18n("Errors"), "icon": "office-chart-bar"});
+                                append({"text": i18n("Fingers"), "icon": "office-chart-bar"});
                             }
                         }
                         textRole: "text"
@@ -411,6 +450,36 @@ FocusScope {
                                 errorsTooltip.close()
                             }
                         }
+
+                        Charts.BarChart{
+                            id: fingerStatsTab
+                            property string title: i18n("Fingers")
+                            property string iconName: "office-chart-bar"
+
+                            model: fingerStatsModel
+                            pitch: 60
+                            textRole: 3 // Qt::ToolTipRole
+                            backgroundColor: colorScheme.normalBackground
+
+                            dimensions: [
+                                Charts.Dimension {
+                                    dataColumn: 0
+                                    color: "#ffb12d"
+                                    maximumValue: Math.max(10, Math.ceil(100 * fingerStatsModel.maximumErrorRate / 10) * 10)
+                                    label: i18n("Error rate")
+                                }
+                            ]
+
+                            onElemEntered: {
+                                fingerStatsTooltip.visualParent = elem;
+                                fingerStatsTooltip.row = row
+                                fingerStatsTooltip.open()
+                            }
+
+                            onElemExited: {
+                                fingerStatsTooltip.close()
+                            }
+                        }
                     }
                 }
             }
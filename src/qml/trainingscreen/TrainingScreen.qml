@@ -88,6 +88,7 @@ FocusScope {
     function reset() {
         toolbar.reset()
         trainingWidget.reset()
+        sessionJournal.begin(screen.profile, screen.course.id, screen.lesson.id)
         screen.trainingStarted = false
         screen.trainingFinished = true
         profileDataAccess.loadReferenceTrainingStats(referenceStats, screen.profile, screen.course.id, screen.lesson.id)
@@ -119,6 +120,8 @@ FocusScope {
 
     TrainingStats {
         id: stats
+        liveUpdates: screen.visible && screen.isActive && preferences.showStatistics
+        keyboardLayout: screen.keyboardLayout
         onTimeIsRunningChanged: {
             if (timeIsRunning) {
                 screen.trainingStarted = false
@@ -130,6 +133,18 @@ FocusScope {
         id: referenceStats
     }
 
+    SessionJournal {
+        id: sessionJournal
+        trainingStats: stats
+    }
+
+    ErrorHeatmap {
+        id: errorHeatmap
+        profile: preferences.showErrorHeatmap? screen.profile: null
+        keyboardLayout: screen.keyboardLayout
+        trainingStats: stats
+    }
+
     Shortcut {
         sequence: "Escape"
         enabled: screen.visible
@@ -184,6 +199,7 @@ FocusScope {
                 width: parent.width - 60
                 stats: stats
                 referenceStats: referenceStats
+                showRecentStats: true
             }
         }
 
@@ -203,6 +219,15 @@ FocusScope {
                 id: trainingWidget
                 anchors.fill: parent
                 lesson: screen.lesson
+                nextLesson: {
+                    if (!screen.course || !screen.lesson)
+                        return null
+                    for (var i = 0; i + 1 < screen.course.lessonCount; i++) {
+                        if (screen.course.lesson(i) === screen.lesson)
+                            return screen.course.lesson(i + 1)
+                    }
+                    return null
+                }
                 keyboardLayout: screen.keyboardLayout
                 trainingStats: stats
                 overlayContainer: trainingOverlayContainer
@@ -211,7 +236,9 @@ FocusScope {
                 onNextCharChanged: keyboard.updateKeyHighlighting()
                 onIsCorrectChanged: keyboard.updateKeyHighlighting()
                 onFinished: {
-                    profileDataAccess.saveTrainingStats(stats, screen.profile, screen.course.id, screen.lesson.id)
+                    profileDataAccess.saveTrainingStats(stats, screen.profile, screen.course.id, screen.lesson.id, sessionJournal.sessionId())
+                    sessionJournal.commit()
+                    errorHeatmap.commit()
                     screen.finished(stats)
                     screen.trainingFinished = true
                 }
@@ -253,28 +280,9 @@ FocusScope {
                 function highlightKey(which) {
                     for (var i = 0; i < highlightedKeys.length; i++)
                         highlightedKeys[i].isHighlighted = false
-                    var keys = findKeyItems(which)
-                    var newHighlightedKeys = []
-                    for (var index = 0; index < keys.length ; index++) {
-                        var key = keys[index]
-                        if (key) {
-                            key.isHighlighted = true
-                            newHighlightedKeys.push(key)
-                            if (typeof which == "string") {
-                                for (var i = 0; i < key.key.keyCharCount; i++) {
-                                    var keyChar = key.key.keyChar(i)
-                                    if (keyChar.value == which && keyChar.modifier != "") {
-                                        var modifier = findModifierKeyItem(keyChar.modifier)
-                                        if (modifier) {
-                                            modifier.isHighlighted = true
-                                            newHighlightedKeys.push(modifier)
-                                        }
-                                        break
-                                    }
-                                }
-                            }
-                        }
-                    }
+                    var newHighlightedKeys = findHighlightKeyItems(which)
+                    for (var index = 0; index < newHighlightedKeys.length; index++)
+                        newHighlightedKeys[index].isHighlighted = true
                     highlightedKeys = newHighlightedKeys
                 }
 
@@ -295,6 +303,7 @@ FocusScope {
                 }
 
                 keyboardLayout: screen.keyboardLayout
+                errorHeatmap: preferences.showErrorHeatmap? errorHeatmap: null
                 anchors {
                     fill: parent
                     leftMargin: 30
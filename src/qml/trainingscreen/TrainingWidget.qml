@@ -25,6 +25,7 @@ FocusScope {
     id: trainingWidget
 
     property Lesson lesson
+    property Lesson nextLesson: null
     property KeyboardLayout keyboardLayout
     property TrainingStats trainingStats
     property Item overlayContainer
@@ -37,6 +38,7 @@ FocusScope {
     signal keyReleased(variant event)
 
     function reset() {
+        latencyMonitor.resetSession()
         stats.reset()
         lessonPainter.reset()
         sheetFlick.scrollToCurrentLine()
@@ -99,24 +101,40 @@ FocusScope {
                 x: 30
                 y: 30
                 width: trainingWidget.width - 60
-                height: lessonPainter.height
+                height: lessonPainter.contentHeight
 
                 border {
                     width: 1
                     color: "#000"
                 }
 
-                LessonPainter {
-                    id: lessonPainter
+                Item {
+                    id: lessonView
                     anchors.centerIn: sheet
-                    lesson: trainingWidget.lesson
-                    maximumWidth: parent.width
-                    trainingLineCore: trainingLine
-
-                    onDone: {
-                        trainingLine.active = false
-                        trainingWidget.finished();
-                        stats.stopTraining();
+                    width: lessonPainter.width
+                    height: lessonPainter.contentHeight
+
+                    LessonPainter {
+                        id: lessonPainter
+                        lesson: trainingWidget.lesson
+                        nextLesson: trainingWidget.nextLesson
+                        maximumWidth: sheet.width
+                        trainingLineCore: trainingLine
+                        visibleArea: Qt.rect(0, sheetFlick.contentY - sheet.y - lessonView.y, width, sheetFlick.height)
+                        visible: !preferences.sceneGraphLessonRendering
+
+                        onDone: {
+                            trainingLine.active = false
+                            latencyMonitor.finishSession(trainingWidget.lesson.id)
+                            trainingWidget.finished();
+                            stats.stopTraining();
+                        }
+                    }
+
+                    LessonSceneGraphItem {
+                        anchors.fill: parent
+                        lessonPainter: lessonPainter
+                        visible: preferences.sceneGraphLessonRendering
                     }
 
                     TrainingLineCore {
@@ -195,6 +213,29 @@ FocusScope {
         }
     }
 
+    Rectangle {
+        id: latencyOverlay
+        visible: latencyMonitor.enabled
+        anchors {
+            top: parent.top
+            right: parent.right
+            margins: 5
+        }
+        width: latencyLabel.width + 10
+        height: latencyLabel.height + 10
+        radius: 3
+        color: "#c0000000"
+
+        Text {
+            id: latencyLabel
+            anchors.centerIn: parent
+            color: "#fff"
+            font.family: "monospace"
+            font.pixelSize: 11
+            text: latencyMonitor.summary
+        }
+    }
+
     KeyItem {
         id: hintKey
         parent: trainingWidget.overlayContainer
@@ -0,0 +1,344 @@
+/*
+ *  Copyright 2026  The KTouch Developers <kde-edu@kde.org>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "replayengine.h"
+
+#include <qmath.h>
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QInputMethodEvent>
+#include <QKeyEvent>
+#include <QRandomGenerator>
+#include <QTextStream>
+#include <QThread>
+
+#include "core/course.h"
+#include "core/lesson.h"
+#include "core/resourcedataaccess.h"
+#include "core/trainingstats.h"
+#include "declarativeitems/lessonpainter.h"
+#include "declarativeitems/traininglinecore.h"
+#include "preferences.h"
+
+ReplayResult::ReplayResult() :
+    eventCount(0),
+    elapsedNSecs(0),
+    maximumEventNSecs(0)
+{
+}
+
+qreal ReplayResult::eventsPerSecond() const
+{
+    return elapsedNSecs > 0? 1e9 * eventCount / elapsedNSecs: 0;
+}
+
+qreal ReplayResult::meanEventNSecs() const
+{
+    return eventCount > 0? qreal(elapsedNSecs) / eventCount: 0;
+}
+
+ReplayEngine::ReplayEngine(QObject* parent) :
+    QObject(parent),
+    m_trainingStats(new TrainingStats(this)),
+    m_trainingLineCore(new TrainingLineCore()),
+    m_lessonPainter(new LessonPainter()),
+    m_rate(0)
+{
+    // neither item ever gets a window, so all their change notifications are
+    // delivered synchronously and nothing is ever painted to the screen
+    m_trainingLineCore->setParent(this);
+    m_lessonPainter->setParent(this);
+
+    m_trainingStats->setLiveUpdates(false);
+    m_trainingLineCore->setTrainingStats(m_trainingStats);
+    m_trainingLineCore->setActive(true);
+    m_lessonPainter->setTrainingLineCore(m_trainingLineCore);
+    m_lessonPainter->setMaximumWidth(1000);
+}
+
+qreal ReplayEngine::rate() const
+{
+    return m_rate;
+}
+
+void ReplayEngine::setRate(qreal rate)
+{
+    m_rate = rate;
+}
+
+TrainingLineCore* ReplayEngine::trainingLineCore() const
+{
+    return m_trainingLineCore;
+}
+
+TrainingStats* ReplayEngine::trainingStats() const
+{
+    return m_trainingStats;
+}
+
+LessonPainter* ReplayEngine::lessonPainter() const
+{
+    return m_lessonPainter;
+}
+
+void ReplayEngine::setLesson(Lesson* lesson)
+{
+    m_trainingStats->reset();
+
+    if (lesson == m_lessonPainter->lesson())
+    {
+        m_lessonPainter->reset();
+    }
+    else
+    {
+        m_lessonPainter->setLesson(lesson);
+    }
+}
+
+ReplayResult ReplayEngine::replay(const QVector<ReplayEvent>& events)
+{
+    ReplayResult result;
+    QElapsedTimer clock;
+    QElapsedTimer eventClock;
+
+    m_trainingStats->startTraining();
+    clock.start();
+
+    foreach (const ReplayEvent& event, events)
+    {
+        if (m_rate > 0)
+        {
+            // a rate of 1 replays in real time, larger rates replay faster
+            const qint64 due = qint64(event.timestamp * 1000000 / m_rate);
+            const qint64 wait = due - clock.nsecsElapsed();
+
+            if (wait > 0)
+            {
+                QThread::usleep(wait / 1000);
+            }
+        }
+
+        eventClock.start();
+
+        deliver(event);
+        const qint64 eventNSecs = eventClock.nsecsElapsed();
+
+        result.eventCount++;
+        result.elapsedNSecs += eventNSecs;
+        result.maximumEventNSecs = qMax(result.maximumEventNSecs, eventNSecs);
+    }
+
+    m_trainingStats->stopTraining();
+
+    return result;
+}
+
+void ReplayEngine::deliver(const ReplayEvent& event)
+{
+    switch (event.type)
+    {
+    case ReplayEvent::KeyPress:
+    {
+        QKeyEvent keyEvent(QEvent::KeyPress, event.key, event.modifiers, event.text);
+        QCoreApplication::sendEvent(m_trainingLineCore, &keyEvent);
+        break;
+    }
+    case ReplayEvent::InputMethod:
+    {
+        QInputMethodEvent inputMethodEvent(event.preeditString, QList<QInputMethodEvent::Attribute>());
+        inputMethodEvent.setCommitString(event.text);
+        QCoreApplication::sendEvent(m_trainingLineCore, &inputMethodEvent);
+        break;
+    }
+    }
+}
+
+QVector<ReplayEvent> ReplayEngine::synthesize(Lesson* lesson, int charactersPerMinute, qreal errorRate, quint32 seed)
+{
+    QVector<ReplayEvent> events;
+
+    if (!lesson || charactersPerMinute <= 0)
+        return events;
+
+    // the units are the same the lesson painter hands to the training line
+    const QStringList lines = LessonPainter::trainingUnits(lesson->text(), Preferences::paragraphTraining());
+    const qint64 interval = 60000 / charactersPerMinute;
+    const int nextLineKey = Preferences::nextLineWithReturn()? Qt::Key_Return: Qt::Key_Space;
+    const QString nextLineText = nextLineKey == Qt::Key_Return? QStringLiteral("\r"): QStringLiteral(" ");
+    QRandomGenerator random(seed);
+    qint64 timestamp = 0;
+
+    auto keyPress = [&](int key, Qt::KeyboardModifiers modifiers, const QString& text) {
+        timestamp += interval;
+        events.append({ReplayEvent::KeyPress, timestamp, key, modifiers, text, QString()});
+    };
+    auto inputMethod = [&](const QString& commitString, const QString& preeditString) {
+        timestamp += interval;
+        events.append({ReplayEvent::InputMethod, timestamp, 0, Qt::NoModifier, commitString, preeditString});
+    };
+
+    events.reserve(qCeil(lesson->text().length() * (1 + 3 * errorRate)) + lines.count());
+
+    foreach (const QString& line, lines)
+    {
+        for (int i = 0; i < line.length(); i++)
+        {
+            const bool surrogatePair = line.at(i).isHighSurrogate() && i + 1 < line.length();
+            const QString character = line.mid(i, surrogatePair? 2: 1);
+
+            if (random.generateDouble() < errorRate)
+            {
+                keyPress(Qt::Key_X, Qt::NoModifier, character == QLatin1String("x")? QStringLiteral("y"): QStringLiteral("x"));
+                keyPress(Qt::Key_Backspace, Qt::NoModifier, QString());
+            }
+
+            if (character.at(0).unicode() < 0x80)
+            {
+                const int key = character.at(0).toUpper().unicode();
+                keyPress(key, character.at(0).isUpper()? Qt::ShiftModifier: Qt::NoModifier, character);
+            }
+            else
+            {
+                // characters outside of ASCII are composed the way an input method would
+                inputMethod(QString(), character);
+                inputMethod(character, QString());
+            }
+
+            if (surrogatePair)
+                i++;
+        }
+
+        keyPress(nextLineKey, Qt::NoModifier, nextLineText);
+    }
+
+    return events;
+}
+
+QStringList ReplayEngine::courseFiles(const QString& path)
+{
+    QStringList result;
+
+    if (QFileInfo(path).isDir())
+    {
+        const QDir dir(path);
+        foreach (const QString& fileName, dir.entryList(QStringList() << QStringLiteral("*.xml"), QDir::Files, QDir::Name))
+        {
+            result.append(dir.filePath(fileName));
+        }
+    }
+    else
+    {
+        result.append(path);
+    }
+
+    return result;
+}
+
+bool ReplayEngine::runBenchmark(const QString& path, qreal rate, QTextStream& out)
+{
+    ResourceDataAccess dataAccess;
+    ReplayEngine engine;
+    ReplayResult total;
+    bool success = true;
+
+    engine.setRate(rate);
+
+    foreach (const QString& courseFile, courseFiles(path))
+    {
+        Course course;
+
+        if (!dataAccess.loadCourse(courseFile, &course))
+        {
+            out << "FAILED " << courseFile << '\n';
+            success = false;
+            continue;
+        }
+
+        for (int i = 0; i < course.lessonCount(); i++)
+        {
+            Lesson* const lesson = course.lesson(i);
+
+            engine.setLesson(lesson);
+            const ReplayResult result = engine.replay(synthesize(lesson));
+
+            out << QFileInfo(courseFile).fileName() << ' ' << lesson->id()
+                << " events=" << result.eventCount
+                << " total_ms=" << result.elapsedNSecs / 1e6
+                << " events_per_s=" << qRound(result.eventsPerSecond())
+                << " mean_us=" << result.meanEventNSecs() / 1e3
+                << " max_us=" << result.maximumEventNSecs / 1e3
+                << " accuracy=" << engine.trainingStats()->accuracy()
+                << '\n';
+
+            total.eventCount += result.eventCount;
+            total.elapsedNSecs += result.elapsedNSecs;
+            total.maximumEventNSecs = qMax(total.maximumEventNSecs, result.maximumEventNSecs);
+        }
+
+        engine.setLesson(0);
+    }
+
+    out << "TOTAL events=" << total.eventCount
+        << " total_ms=" << total.elapsedNSecs / 1e6
+        << " events_per_s=" << qRound(total.eventsPerSecond())
+        << " mean_us=" << total.meanEventNSecs() / 1e3
+        << " max_us=" << total.maximumEventNSecs / 1e3
+        << '\n';
+    out.flush();
+
+    return success;
+}
+
+bool ReplayEngine::runLineLengthBenchmark(QTextStream& out)
+{
+    const QString words = QStringLiteral("the quick brown fox jumps over the lazy dog ");
+    ReplayEngine engine;
+
+    // the cost of a keystroke should not grow with the length of the trained line
+    for (int length = 10; length <= 10000; length *= 10)
+    {
+        QString line;
+        line.reserve(length + words.length());
+
+        while (line.length() < length)
+        {
+            line += words;
+        }
+
+        Lesson lesson;
+        lesson.setId(QStringLiteral("line-length-%1").arg(length));
+        lesson.setTitle(lesson.id());
+        lesson.setText(line.left(length));
+
+        engine.setLesson(&lesson);
+        const ReplayResult result = engine.replay(synthesize(&lesson));
+        engine.setLesson(0);
+
+        out << "line_length=" << length
+            << " events=" << result.eventCount
+            << " total_ms=" << result.elapsedNSecs / 1e6
+            << " mean_us=" << result.meanEventNSecs() / 1e3
+            << " max_us=" << result.maximumEventNSecs / 1e3
+            << '\n';
+    }
+
+    out.flush();
+
+    return true;
+}
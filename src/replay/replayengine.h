@@ -0,0 +1,86 @@
+/*
+ *  Copyright 2026  The KTouch Developers <kde-edu@kde.org>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef REPLAYENGINE_H
+#define REPLAYENGINE_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+class QTextStream;
+
+class Lesson;
+class LessonPainter;
+class TrainingLineCore;
+class TrainingStats;
+
+struct ReplayEvent
+{
+    enum Type {
+        KeyPress,
+        InputMethod
+    };
+
+    Type type;
+    qint64 timestamp;
+    int key;
+    Qt::KeyboardModifiers modifiers;
+    QString text;
+    QString preeditString;
+};
+
+Q_DECLARE_TYPEINFO(ReplayEvent, Q_MOVABLE_TYPE);
+
+struct ReplayResult
+{
+    ReplayResult();
+    int eventCount;
+    qint64 elapsedNSecs;
+    qint64 maximumEventNSecs;
+    qreal eventsPerSecond() const;
+    qreal meanEventNSecs() const;
+};
+
+class ReplayEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ReplayEngine(QObject* parent = 0);
+    qreal rate() const;
+    void setRate(qreal rate);
+    TrainingLineCore* trainingLineCore() const;
+    TrainingStats* trainingStats() const;
+    LessonPainter* lessonPainter() const;
+    void setLesson(Lesson* lesson);
+    ReplayResult replay(const QVector<ReplayEvent>& events);
+    void deliver(const ReplayEvent& event);
+    static QVector<ReplayEvent> synthesize(Lesson* lesson, int charactersPerMinute = 300, qreal errorRate = 0.02, quint32 seed = 1);
+    static QStringList courseFiles(const QString& path);
+    static bool runBenchmark(const QString& path, qreal rate, QTextStream& out);
+    static bool runLineLengthBenchmark(QTextStream& out);
+
+private:
+    TrainingStats* m_trainingStats;
+    TrainingLineCore* m_trainingLineCore;
+    LessonPainter* m_lessonPainter;
+    qreal m_rate;
+};
+
+#endif // REPLAYENGINE_H
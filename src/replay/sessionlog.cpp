@@ -0,0 +1,72 @@
+/*
+ *  Copyright 2026  The KTouch Developers <kde-edu@kde.org>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "sessionlog.h"
+
+const QByteArray SessionLog::Magic = QByteArrayLiteral("KTSL\x01");
+
+void SessionLog::writeVarint(QByteArray& buffer, quint64 value)
+{
+    while (value >= 0x80)
+    {
+        buffer.append(char((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+
+    buffer.append(char(value));
+}
+
+void SessionLog::writeString(QByteArray& buffer, const QString& string)
+{
+    const QByteArray utf8 = string.toUtf8();
+    writeVarint(buffer, quint64(utf8.size()));
+    buffer.append(utf8);
+}
+
+bool SessionLog::readVarint(const QByteArray& buffer, int& position, quint64& value)
+{
+    value = 0;
+
+    for (int shift = 0; shift < 64 && position < buffer.size(); shift += 7)
+    {
+        const uchar byte = uchar(buffer.at(position++));
+        value |= quint64(byte & 0x7f) << shift;
+
+        if (!(byte & 0x80))
+            return true;
+    }
+
+    return false;
+}
+
+bool SessionLog::readString(const QByteArray& buffer, int& position, QString& string)
+{
+    quint64 size;
+
+    if (!readVarint(buffer, position, size) || size > quint64(buffer.size() - position))
+        return false;
+
+    string = QString::fromUtf8(buffer.constData() + position, int(size));
+    position += int(size);
+    return true;
+}
+
+quint16 SessionLog::checksum(const QString& text)
+{
+    const QByteArray utf8 = text.toUtf8();
+    return qChecksum(utf8.constData(), uint(utf8.size()));
+}
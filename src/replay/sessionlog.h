@@ -0,0 +1,60 @@
+/*
+ *  Copyright 2026  The KTouch Developers <kde-edu@kde.org>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SESSIONLOG_H
+#define SESSIONLOG_H
+
+#include <QByteArray>
+#include <QString>
+
+/*
+ * Session logs are a magic header followed by a stream of records. Every
+ * record is a type byte followed by unsigned LEB128 varints; strings are a
+ * varint byte count followed by UTF-8. Timed records carry the time since
+ * the previous timed record of the session in microseconds, so a typical
+ * keystroke takes five bytes. Every lesson record is preceded by the input
+ * settings it was trained with. Files may be appended to at any time.
+ */
+namespace SessionLog
+{
+    enum RecordType {
+        ResetRecord = 1, // wall clock time in ms since the epoch
+        LessonRecord, // lesson id, checksum of the lesson text
+        LineRecord, // line index
+        StartRecord, // time delta
+        StopRecord, // time delta
+        CharacterRecord, // time delta, code point
+        KeyRecord, // time delta, key, modifiers, text
+        InputMethodRecord, // time delta, commit string, preedit string
+        InputPolicyRecord // policy flags, key for the next line or 0
+    };
+
+    enum InputPolicyFlag {
+        EnforceErrorCorrection = 0x1,
+        ParagraphTraining = 0x2
+    };
+
+    extern const QByteArray Magic;
+
+    void writeVarint(QByteArray& buffer, quint64 value);
+    void writeString(QByteArray& buffer, const QString& string);
+    bool readVarint(const QByteArray& buffer, int& position, quint64& value);
+    bool readString(const QByteArray& buffer, int& position, QString& string);
+    quint16 checksum(const QString& text);
+}
+
+#endif // SESSIONLOG_H
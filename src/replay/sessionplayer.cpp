@@ -0,0 +1,372 @@
+/*
+ *  Copyright 2026  The KTouch Developers <kde-edu@kde.org>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "sessionplayer.h"
+
+#include <QFile>
+#include <QHash>
+#include <QTextStream>
+
+#include "core/course.h"
+#include "core/lesson.h"
+#include "core/resourcedataaccess.h"
+#include "core/trainingstats.h"
+#include "declarativeitems/lessonpainter.h"
+#include "declarativeitems/traininglinecore.h"
+#include "replay/replayengine.h"
+#include "replay/sessionlog.h"
+#include "preferences.h"
+
+SessionPlayer::SessionPlayer(const QByteArray& log) :
+    m_log(log),
+    m_position(SessionLog::Magic.size()),
+    m_valid(log.startsWith(SessionLog::Magic)),
+    m_eventCount(0)
+{
+    if (!m_valid)
+    {
+        m_errorString = QStringLiteral("not a session log");
+    }
+}
+
+bool SessionPlayer::isValid() const
+{
+    return m_valid;
+}
+
+bool SessionPlayer::atEnd() const
+{
+    return !m_valid || m_position >= m_log.size();
+}
+
+QString SessionPlayer::errorString() const
+{
+    return m_errorString;
+}
+
+QDateTime SessionPlayer::sessionStart() const
+{
+    return m_sessionStart;
+}
+
+QString SessionPlayer::lessonId() const
+{
+    return m_lessonId;
+}
+
+int SessionPlayer::eventCount() const
+{
+    return m_eventCount;
+}
+
+bool SessionPlayer::playSession(ReplayEngine* engine, const LessonResolver& resolveLesson)
+{
+    if (atEnd())
+        return false;
+
+    quint64 value;
+
+    m_errorString.clear();
+    m_lessonId.clear();
+    m_eventCount = 0;
+
+    if (m_log.at(m_position) != char(SessionLog::ResetRecord))
+    {
+        // whatever was recorded before the first reset belongs to no session
+        skipSession();
+
+        if (atEnd())
+            return fail(QStringLiteral("no session found"));
+    }
+
+    m_position++;
+
+    if (!SessionLog::readVarint(m_log, m_position, value))
+        return truncated();
+
+    m_sessionStart = QDateTime::fromMSecsSinceEpoch(qint64(value));
+
+    TrainingStats* const trainingStats = engine->trainingStats();
+    TrainingLineCore* const trainingLineCore = engine->trainingLineCore();
+    LessonPainter* const lessonPainter = engine->lessonPainter();
+    Lesson* lesson = 0;
+    qint64 time = 0;
+
+    trainingStats->reset();
+
+    while (m_position < m_log.size() && m_log.at(m_position) != char(SessionLog::ResetRecord))
+    {
+        const int recordType = m_log.at(m_position++);
+
+        switch (recordType)
+        {
+        case SessionLog::InputPolicyRecord:
+        {
+            quint64 nextLineKey;
+
+            if (!SessionLog::readVarint(m_log, m_position, value) || !SessionLog::readVarint(m_log, m_position, nextLineKey))
+                return truncated();
+
+            // the settings are only changed in memory, they are never saved by a replay
+            Preferences::setEnforceTypingErrorCorrection(value & SessionLog::EnforceErrorCorrection);
+            Preferences::setParagraphTraining(value & SessionLog::ParagraphTraining);
+            Preferences::setNextLineWithReturn(nextLineKey == Qt::Key_Return);
+            Preferences::setNextLineWithSpace(nextLineKey == Qt::Key_Space);
+            trainingLineCore->updateInputPolicy();
+            break;
+        }
+        case SessionLog::LessonRecord:
+        {
+            if (!SessionLog::readString(m_log, m_position, m_lessonId) || !SessionLog::readVarint(m_log, m_position, value))
+                return truncated();
+
+            lesson = resolveLesson(m_lessonId);
+
+            if (!lesson || SessionLog::checksum(lesson->text()) != quint16(value))
+            {
+                skipSession();
+                return fail(QStringLiteral("lesson %1 is not available").arg(m_lessonId));
+            }
+
+            if (lesson == lessonPainter->lesson())
+            {
+                lessonPainter->reset();
+            }
+            else
+            {
+                lessonPainter->setLesson(lesson);
+            }
+
+            break;
+        }
+        case SessionLog::LineRecord:
+        {
+            if (!SessionLog::readVarint(m_log, m_position, value))
+                return truncated();
+
+            if (lessonPainter->currentLine() != int(value))
+            {
+                skipSession();
+                return fail(QStringLiteral("replay went out of sync at line %1").arg(value));
+            }
+
+            break;
+        }
+        case SessionLog::StartRecord:
+        case SessionLog::StopRecord:
+        case SessionLog::CharacterRecord:
+        case SessionLog::KeyRecord:
+        case SessionLog::InputMethodRecord:
+        {
+            if (!SessionLog::readVarint(m_log, m_position, value))
+                return truncated();
+
+            time += qint64(value);
+
+            ReplayEvent event = {ReplayEvent::KeyPress, time / 1000, 0, Qt::NoModifier, QString(), QString()};
+            bool isEvent = true;
+
+            if (recordType == SessionLog::CharacterRecord)
+            {
+                if (!SessionLog::readVarint(m_log, m_position, value))
+                    return truncated();
+
+                const QChar character(ushort(value));
+                event.key = character.toUpper().unicode();
+                event.modifiers = character.isUpper()? Qt::ShiftModifier: Qt::NoModifier;
+                event.text = QString(character);
+            }
+            else if (recordType == SessionLog::KeyRecord)
+            {
+                quint64 modifiers;
+
+                if (!SessionLog::readVarint(m_log, m_position, value) ||
+                        !SessionLog::readVarint(m_log, m_position, modifiers) ||
+                        !SessionLog::readString(m_log, m_position, event.text))
+                    return truncated();
+
+                event.key = int(value);
+                event.modifiers = Qt::KeyboardModifiers(int(modifiers << 25));
+            }
+            else if (recordType == SessionLog::InputMethodRecord)
+            {
+                event.type = ReplayEvent::InputMethod;
+
+                if (!SessionLog::readString(m_log, m_position, event.text) ||
+                        !SessionLog::readString(m_log, m_position, event.preeditString))
+                    return truncated();
+            }
+            else
+            {
+                isEvent = false;
+            }
+
+            // the recorded microsecond timestamps are exactly what the training
+            // stats saw during the session
+            trainingStats->latchClockAt(time * 1000);
+
+            if (recordType == SessionLog::StartRecord)
+            {
+                trainingStats->startTraining();
+            }
+            else if (recordType == SessionLog::StopRecord)
+            {
+                trainingStats->stopTraining();
+            }
+            else if (isEvent)
+            {
+                engine->deliver(event);
+                m_eventCount++;
+            }
+
+            trainingStats->releaseClock();
+            break;
+        }
+        default:
+            m_position = m_log.size();
+            return fail(QStringLiteral("unknown record type %1").arg(recordType));
+        }
+    }
+
+    return true;
+}
+
+bool SessionPlayer::playFile(const QString& logFile, const QString& coursePath, QTextStream& out)
+{
+    QFile file(logFile);
+
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        out << "FAILED " << logFile << ": " << file.errorString() << '\n';
+        return false;
+    }
+
+    ResourceDataAccess dataAccess;
+    QList<Course*> courses;
+    QHash<QString, Lesson*> lessons;
+
+    foreach (const QString& courseFile, ReplayEngine::courseFiles(coursePath))
+    {
+        Course* course = new Course();
+
+        if (!dataAccess.loadCourse(courseFile, course))
+        {
+            delete course;
+            continue;
+        }
+
+        courses.append(course);
+
+        for (int i = 0; i < course->lessonCount(); i++)
+        {
+            lessons.insert(course->lesson(i)->id(), course->lesson(i));
+        }
+    }
+
+    SessionPlayer player(file.readAll());
+    ReplayEngine engine;
+    bool success = player.isValid();
+
+    if (!success)
+    {
+        out << "FAILED " << logFile << ": " << player.errorString() << '\n';
+    }
+
+    while (!player.atEnd())
+    {
+        if (!player.playSession(&engine, [&lessons](const QString& lessonId) { return lessons.value(lessonId); }))
+        {
+            out << "SKIPPED " << player.lessonId() << ": " << player.errorString() << '\n';
+            success = false;
+            continue;
+        }
+
+        TrainingStats* const stats = engine.trainingStats();
+
+        out << player.sessionStart().toString(Qt::ISODate) << ' ' << player.lessonId()
+            << " events=" << player.eventCount()
+            << " characters=" << stats->charactesTyped()
+            << " errors=" << stats->errorCount()
+            << " elapsed_ms=" << stats->elapsedMSecs()
+            << " cpm=" << stats->charactersPerMinute()
+            << " accuracy=" << stats->accuracy()
+            << '\n';
+    }
+
+    engine.lessonPainter()->setLesson(0);
+    qDeleteAll(courses);
+    out.flush();
+
+    return success;
+}
+
+bool SessionPlayer::fail(const QString& errorString)
+{
+    m_errorString = errorString;
+    return false;
+}
+
+bool SessionPlayer::truncated()
+{
+    m_position = m_log.size();
+    return fail(QStringLiteral("truncated record"));
+}
+
+void SessionPlayer::skipSession()
+{
+    quint64 value;
+    QString string;
+
+    while (m_position < m_log.size() && m_log.at(m_position) != char(SessionLog::ResetRecord))
+    {
+        bool valid = true;
+
+        switch (m_log.at(m_position++))
+        {
+        case SessionLog::LessonRecord:
+            valid = SessionLog::readString(m_log, m_position, string) && SessionLog::readVarint(m_log, m_position, value);
+            break;
+        case SessionLog::LineRecord:
+        case SessionLog::StartRecord:
+        case SessionLog::StopRecord:
+            valid = SessionLog::readVarint(m_log, m_position, value);
+            break;
+        case SessionLog::InputPolicyRecord:
+            valid = SessionLog::readVarint(m_log, m_position, value) && SessionLog::readVarint(m_log, m_position, value);
+            break;
+        case SessionLog::CharacterRecord:
+            valid = SessionLog::readVarint(m_log, m_position, value) && SessionLog::readVarint(m_log, m_position, value);
+            break;
+        case SessionLog::KeyRecord:
+            valid = SessionLog::readVarint(m_log, m_position, value) && SessionLog::readVarint(m_log, m_position, value) &&
+                    SessionLog::readVarint(m_log, m_position, value) && SessionLog::readString(m_log, m_position, string);
+            break;
+        case SessionLog::InputMethodRecord:
+            valid = SessionLog::readVarint(m_log, m_position, value) && SessionLog::readString(m_log, m_position, string) &&
+                    SessionLog::readString(m_log, m_position, string);
+            break;
+        default:
+            valid = false;
+        }
+
+        if (!valid)
+        {
+            // records aren't self-delimiting, there is no way to resynchronize
+            m_position = m_log.size();
+        }
+    }
+}
@@ -0,0 +1,60 @@
+/*
+ *  Copyright 2026  The KTouch Developers <kde-edu@kde.org>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SESSIONPLAYER_H
+#define SESSIONPLAYER_H
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QString>
+
+#include <functional>
+
+class QTextStream;
+
+class Lesson;
+class ReplayEngine;
+
+class SessionPlayer
+{
+public:
+    typedef std::function<Lesson* (const QString& lessonId)> LessonResolver;
+
+    explicit SessionPlayer(const QByteArray& log);
+    bool isValid() const;
+    bool atEnd() const;
+    QString errorString() const;
+    QDateTime sessionStart() const;
+    QString lessonId() const;
+    int eventCount() const;
+    bool playSession(ReplayEngine* engine, const LessonResolver& resolveLesson);
+    static bool playFile(const QString& logFile, const QString& coursePath, QTextStream& out);
+
+private:
+    bool fail(const QString& errorString);
+    bool truncated();
+    void skipSession();
+    QByteArray m_log;
+    int m_position;
+    bool m_valid;
+    QString m_errorString;
+    QDateTime m_sessionStart;
+    QString m_lessonId;
+    int m_eventCount;
+};
+
+#endif // SESSIONPLAYER_H
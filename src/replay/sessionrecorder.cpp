@@ -0,0 +1,234 @@
+/*
+ *  Copyright 2026  The KTouch Developers <kde-edu@kde.org>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "sessionrecorder.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDateTime>
+#include <QFile>
+#include <QInputMethodEvent>
+#include <QKeyEvent>
+
+#include "core/lesson.h"
+#include "core/trainingstats.h"
+#include "replay/sessionlog.h"
+#include "preferences.h"
+
+// buffered records are written out at the latest when this much has accumulated
+static const int FlushThreshold = 4096;
+
+SessionRecorder* SessionRecorder::self()
+{
+    static SessionRecorder* instance = new SessionRecorder(QCoreApplication::instance());
+    return instance;
+}
+
+SessionRecorder::SessionRecorder(QObject* parent) :
+    QObject(parent),
+    m_lastTime(0)
+{
+}
+
+SessionRecorder::~SessionRecorder()
+{
+    flush();
+}
+
+bool SessionRecorder::isEnabled() const
+{
+    return !m_logFile.isEmpty();
+}
+
+QString SessionRecorder::logFile() const
+{
+    return m_logFile;
+}
+
+void SessionRecorder::setLogFile(const QString& logFile)
+{
+    flush();
+    m_logFile = logFile;
+}
+
+void SessionRecorder::attachTrainingStats(TrainingStats* trainingStats)
+{
+    if (!trainingStats)
+        return;
+
+    connect(trainingStats, &TrainingStats::sessionReset, this, &SessionRecorder::recordReset, Qt::UniqueConnection);
+    connect(trainingStats, &TrainingStats::trainingStarted, this, &SessionRecorder::recordStart, Qt::UniqueConnection);
+    connect(trainingStats, &TrainingStats::trainingStopped, this, &SessionRecorder::recordStop, Qt::UniqueConnection);
+}
+
+void SessionRecorder::recordLesson(Lesson* lesson)
+{
+    if (!isEnabled() || !lesson)
+        return;
+
+    // the keystrokes only replay the same way with the same input settings
+    int flags = 0;
+    int nextLineKey = 0;
+
+    if (Preferences::enforceTypingErrorCorrection())
+    {
+        flags |= SessionLog::EnforceErrorCorrection;
+    }
+
+    if (Preferences::paragraphTraining())
+    {
+        flags |= SessionLog::ParagraphTraining;
+    }
+
+    if (Preferences::nextLineWithReturn())
+    {
+        nextLineKey = Qt::Key_Return;
+    }
+    else if (Preferences::nextLineWithSpace())
+    {
+        nextLineKey = Qt::Key_Space;
+    }
+
+    m_buffer.append(char(SessionLog::InputPolicyRecord));
+    SessionLog::writeVarint(m_buffer, quint64(flags));
+    SessionLog::writeVarint(m_buffer, quint64(nextLineKey));
+
+    m_buffer.append(char(SessionLog::LessonRecord));
+    SessionLog::writeString(m_buffer, lesson->id());
+    SessionLog::writeVarint(m_buffer, SessionLog::checksum(lesson->text()));
+}
+
+void SessionRecorder::recordLine(int line)
+{
+    if (!isEnabled())
+        return;
+
+    m_buffer.append(char(SessionLog::LineRecord));
+    SessionLog::writeVarint(m_buffer, quint64(qMax(0, line)));
+}
+
+void SessionRecorder::recordEvent(QEvent* event, qint64 nsecs)
+{
+    if (!isEnabled())
+        return;
+
+    if (event->type() == QEvent::KeyPress)
+    {
+        const QKeyEvent* keyEvent = static_cast<QKeyEvent*>(event);
+        const QString text = keyEvent->text();
+        const QChar character = text.length() == 1? text.at(0): QChar();
+        const Qt::KeyboardModifiers modifiers = keyEvent->modifiers() & ~Qt::KeypadModifier;
+
+        // the common case of a plain printable key only needs its code point
+        if (character.isPrint() && keyEvent->key() == character.toUpper().unicode() &&
+                modifiers == (character.isUpper()? Qt::ShiftModifier: Qt::NoModifier))
+        {
+            m_buffer.append(char(SessionLog::CharacterRecord));
+            writeTime(nsecs);
+            SessionLog::writeVarint(m_buffer, character.unicode());
+        }
+        else
+        {
+            m_buffer.append(char(SessionLog::KeyRecord));
+            writeTime(nsecs);
+            SessionLog::writeVarint(m_buffer, quint64(uint(keyEvent->key())));
+            SessionLog::writeVarint(m_buffer, quint64(uint(keyEvent->modifiers())) >> 25);
+            SessionLog::writeString(m_buffer, text);
+        }
+    }
+    else if (event->type() == QEvent::InputMethod)
+    {
+        const QInputMethodEvent* inputMethodEvent = static_cast<QInputMethodEvent*>(event);
+
+        m_buffer.append(char(SessionLog::InputMethodRecord));
+        writeTime(nsecs);
+        SessionLog::writeString(m_buffer, inputMethodEvent->commitString());
+        SessionLog::writeString(m_buffer, inputMethodEvent->preeditString());
+    }
+    else
+    {
+        return;
+    }
+
+    if (m_buffer.size() >= FlushThreshold)
+    {
+        flush();
+    }
+}
+
+void SessionRecorder::flush()
+{
+    if (m_buffer.isEmpty() || m_logFile.isEmpty())
+        return;
+
+    QFile file(m_logFile);
+
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append))
+    {
+        qWarning() << "can't open session log" << m_logFile << file.errorString();
+        m_buffer.clear();
+        return;
+    }
+
+    if (file.size() == 0)
+    {
+        file.write(SessionLog::Magic);
+    }
+
+    file.write(m_buffer);
+    m_buffer.clear();
+}
+
+void SessionRecorder::recordReset()
+{
+    if (!isEnabled())
+        return;
+
+    m_buffer.append(char(SessionLog::ResetRecord));
+    SessionLog::writeVarint(m_buffer, quint64(QDateTime::currentMSecsSinceEpoch()));
+    m_lastTime = 0;
+}
+
+void SessionRecorder::recordStart()
+{
+    TrainingStats* trainingStats = qobject_cast<TrainingStats*>(sender());
+
+    if (!isEnabled() || !trainingStats)
+        return;
+
+    m_buffer.append(char(SessionLog::StartRecord));
+    writeTime(trainingStats->clockNSecs());
+}
+
+void SessionRecorder::recordStop()
+{
+    TrainingStats* trainingStats = qobject_cast<TrainingStats*>(sender());
+
+    if (!isEnabled() || !trainingStats)
+        return;
+
+    m_buffer.append(char(SessionLog::StopRecord));
+    writeTime(trainingStats->clockNSecs());
+    flush();
+}
+
+void SessionRecorder::writeTime(qint64 nsecs)
+{
+    const qint64 usecs = nsecs / 1000;
+    SessionLog::writeVarint(m_buffer, quint64(qMax(Q_INT64_C(0), usecs - m_lastTime)));
+    m_lastTime = usecs;
+}
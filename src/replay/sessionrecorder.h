@@ -0,0 +1,61 @@
+/*
+ *  Copyright 2026  The KTouch Developers <kde-edu@kde.org>
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License as
+ *  published by the Free Software Foundation; either version 2 of
+ *  the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SESSIONRECORDER_H
+#define SESSIONRECORDER_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QString>
+
+class QEvent;
+
+class Lesson;
+class TrainingStats;
+
+class SessionRecorder : public QObject
+{
+    Q_OBJECT
+
+public:
+    static SessionRecorder* self();
+    ~SessionRecorder();
+    bool isEnabled() const;
+    QString logFile() const;
+    void setLogFile(const QString& logFile);
+    void attachTrainingStats(TrainingStats* trainingStats);
+    void recordLesson(Lesson* lesson);
+    void recordLine(int line);
+    void recordEvent(QEvent* event, qint64 nsecs);
+
+public slots:
+    void flush();
+
+private slots:
+    void recordReset();
+    void recordStart();
+    void recordStop();
+
+private:
+    explicit SessionRecorder(QObject* parent = 0);
+    void writeTime(qint64 nsecs);
+    QString m_logFile;
+    QByteArray m_buffer;
+    qint64 m_lastTime;
+};
+
+#endif // SESSIONRECORDER_H